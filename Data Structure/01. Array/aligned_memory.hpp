@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#ifndef ALIGNED_MEMORY_HPP
+
+#define ALIGNED_MEMORY_HPP
+
+// Raw block allocation with a chosen alignment and optional transparent huge
+// pages, shared by Array and DynArray.
+namespace memory
+{
+  // Size of a transparent huge page on x86-64 and most arm64 kernels
+  const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  // Huge pages only pay off for blocks spanning at least one of them
+  inline bool usesHugePages(std::size_t bytes, bool hugePages)
+  {
+    return hugePages && bytes >= HUGE_PAGE_SIZE;
+  }
+
+  // Asks the kernel to back the block with huge pages. It is only a hint,
+  // so a kernel without THP support simply ignores it.
+  inline void adviseHugePages(void *block, std::size_t bytes)
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    madvise(block, bytes, MADV_HUGEPAGE);
+#else
+    (void)block;
+    (void)bytes;
+#endif
+  }
+
+  inline std::size_t effectiveAlignment(std::size_t bytes, std::size_t alignment, bool hugePages)
+  {
+    // A huge page can only back a range that starts on a huge page boundary
+    if (usesHugePages(bytes, hugePages) && alignment < HUGE_PAGE_SIZE)
+    {
+      return HUGE_PAGE_SIZE;
+    }
+    return alignment;
+  }
+
+  inline void *allocate(std::size_t bytes, std::size_t alignment, bool hugePages)
+  {
+    std::size_t align = effectiveAlignment(bytes, alignment, hugePages);
+    void *block = align > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new(bytes, std::align_val_t(align)) : ::operator new(bytes);
+
+    if (usesHugePages(bytes, hugePages))
+    {
+      adviseHugePages(block, bytes);
+    }
+    return block;
+  }
+
+  // Must get the same size, alignment and huge page flag as allocate()
+  inline void deallocate(void *block, std::size_t bytes, std::size_t alignment, bool hugePages)
+  {
+    std::size_t align = effectiveAlignment(bytes, alignment, hugePages);
+
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+      ::operator delete(block, std::align_val_t(align));
+    }
+    else
+    {
+      ::operator delete(block);
+    }
+  }
+}
+
+#endif
@@ -1,20 +1,50 @@
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
 #include "custom_exception"
+#include "check_policy.hpp"
+#include "dynamic_array.cpp"
+#include "simd_kernels.hpp"
+#include "aligned_memory.hpp"
 
 using namespace std;
 
-template <typename T>
+// Alignment sets the alignment of the item block (e.g. 64 for cache-line
+// aligned vector loads); it is never less than alignof(T).
+template <typename T, typename CheckPolicy = Checked, std::size_t Alignment = alignof(T)>
 class Array
 {
+  static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
   private:
+    static constexpr std::size_t ALIGNMENT = Alignment < alignof(T) ? alignof(T) : Alignment;
+
     int capacity;
     int lastIndex;
+    bool hugePages;
     T *ptr;
+
+    // Allocates a block of 'size' default constructed items
+    T *allocate(int) const;
   protected:
     void clear();
+
+    // Shifts the items from the given index 'count' steps right in one move
+    void openGap(int, int);
   public:
-    Array(int);
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    // Passing true for the second argument backs arrays of 2 MiB or more
+    // with transparent huge pages
+    Array(int, bool = false);
     ~Array();
     Array(const Array&);
     Array& operator=(const Array&);
@@ -23,38 +53,74 @@ class Array
     void insert(T, int);
     void remove(int);
     void replace(T, int);
+
+    // Inserts the items of [first, last) at the given index, shifting the
+    // tail once. The range must not point into this array.
+    template <typename InputIt>
+    void insertRange(int, InputIt, InputIt);
+
+    // Removes 'count' items starting at the given index
+    void removeRange(int, int);
+
+    // Removes every item for which the predicate is true in a single pass
+    // and returns how many were removed
+    template <typename Predicate>
+    int removeIf(Predicate);
     
     T getItem(int) const;
-    int findIndex(T) const;
+
+    // Reference access; operator[] follows CheckPolicy, at() always throws
+    T &operator[](int);
+    const T &operator[](int) const;
+    T &at(int);
+    const T &at(int) const;
+
+    int findIndex(const T &) const;
+    DynArray<int> findAll(const T &) const;
+    int count(const T &) const;
+    bool containsAny(const T *, int) const;
+#if __cplusplus >= 202002L
+    bool containsAny(std::span<const T>) const;
+#endif
     bool isFull() const;
     bool isEmpty() const;
     int countItems() const;
     void display() const;
+
+    // The items as one contiguous block
+    T *data();
+    const T *data() const;
+    int size() const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
 };
 
 
-template <typename T>
-Array<T>::Array(int size)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+Array<T, CheckPolicy, Alignment>::Array(int size, bool useHugePages)
 {
   if (size < 1)
   {
     throw InvalidCapacity("Size of array must be 1 or more.");
   }
 
-  ptr = new T[size];
+  hugePages = useHugePages;
+  ptr = allocate(size);
 
   capacity = size;
   lastIndex = -1;
 }
 
-template <typename T>
-Array<T>::~Array()
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+Array<T, CheckPolicy, Alignment>::~Array()
 {
   clear();
 }
 
-template <typename T>
-Array<T>::Array(const Array &obj)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+Array<T, CheckPolicy, Alignment>::Array(const Array &obj)
 {
   if (this == &obj)
   {
@@ -63,7 +129,8 @@ Array<T>::Array(const Array &obj)
 
   capacity = obj.capacity;
   lastIndex = obj.lastIndex;
-  ptr = new T[capacity];
+  hugePages = obj.hugePages;
+  ptr = allocate(capacity);
 
   for (int i = 0; i <= lastIndex; i++)
   {
@@ -71,8 +138,8 @@ Array<T>::Array(const Array &obj)
   }
 }
 
-template <typename T>
-Array<T>& Array<T>::operator=(const Array &obj)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+Array<T, CheckPolicy, Alignment>& Array<T, CheckPolicy, Alignment>::operator=(const Array &obj)
 {
   if(this!=&obj){
     // freeing memory of array
@@ -80,7 +147,8 @@ Array<T>& Array<T>::operator=(const Array &obj)
 
     capacity = obj.capacity;
     lastIndex = obj.lastIndex;
-    ptr = new T[capacity];
+    hugePages = obj.hugePages;
+    ptr = allocate(capacity);
 
     for (int i = 0; i <= lastIndex; i++)
     {
@@ -91,30 +159,50 @@ Array<T>& Array<T>::operator=(const Array &obj)
   return *this;
 }
 
-template <typename T>
-void Array<T>::clear()
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+T *Array<T, CheckPolicy, Alignment>::allocate(int size) const
+{
+  std::size_t bytes = static_cast<std::size_t>(size) * sizeof(T);
+  T *block = static_cast<T *>(memory::allocate(bytes, ALIGNMENT, hugePages));
+
+  try
+  {
+    uninitialized_default_construct_n(block, size);
+  }
+  catch (...)
+  {
+    memory::deallocate(block, bytes, ALIGNMENT, hugePages);
+    throw;
+  }
+
+  return block;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::clear()
 {
   if (ptr != nullptr)
   {
-    delete[] ptr;
+    destroy_n(ptr, capacity);
+    memory::deallocate(ptr, static_cast<std::size_t>(capacity) * sizeof(T), ALIGNMENT, hugePages);
     ptr = nullptr;
   }
 }
 
-template <typename T>
-bool Array<T>::isEmpty() const
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+bool Array<T, CheckPolicy, Alignment>::isEmpty() const
 {
   return lastIndex == -1;
 }
 
-template <typename T>
-bool Array<T>::isFull() const
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+bool Array<T, CheckPolicy, Alignment>::isFull() const
 {
   return capacity == lastIndex + 1;
 }
 
-template <typename T>
-void Array<T>::append(T item)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::append(T item)
 {
   if (isFull())
   {
@@ -125,8 +213,8 @@ void Array<T>::append(T item)
   ptr[lastIndex] = item;
 }
 
-template <typename T>
-void Array<T>::insert(T item, int index)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::insert(T item, int index)
 {
 
   if (isFull())
@@ -148,8 +236,8 @@ void Array<T>::insert(T item, int index)
   lastIndex++;
 }
 
-template <typename T>
-void Array<T>::remove(int index)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::remove(int index)
 {
   if (isEmpty())
   {
@@ -169,15 +257,94 @@ void Array<T>::remove(int index)
   lastIndex--;
 }
 
-template <typename T>
-int Array<T>::countItems() const
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::openGap(int index, int count)
+{
+  if (lastIndex + 1 + count > capacity)
+  {
+    throw ArrayOverflow("Cannot insert the items because array does not have enough space.");
+  }
+
+  move_backward(ptr + index, ptr + lastIndex + 1, ptr + lastIndex + 1 + count);
+  lastIndex += count;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+template <typename InputIt>
+void Array<T, CheckPolicy, Alignment>::insertRange(int index, InputIt first, InputIt last)
+{
+  if (index < 0 || index > lastIndex + 1)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  using Category = typename iterator_traits<InputIt>::iterator_category;
+  if constexpr (!is_base_of<forward_iterator_tag, Category>::value)
+  {
+    // A single pass range has to be counted before the tail can move
+    DynArray<T> items;
+    for (; first != last; ++first)
+    {
+      items.append(*first);
+    }
+
+    int count = items.countItems();
+    openGap(index, count);
+    for (int i = 0; i < count; i++)
+    {
+      ptr[index + i] = items.getItem(i);
+    }
+  }
+  else
+  {
+    openGap(index, static_cast<int>(distance(first, last)));
+    copy(first, last, ptr + index);
+  }
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::removeRange(int index, int count)
+{
+  if (index < 0 || count < 0 || index + count > lastIndex + 1)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  if (count == 0)
+  {
+    return;
+  }
+
+  move(ptr + index + count, ptr + lastIndex + 1, ptr + index);
+  lastIndex -= count;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+template <typename Predicate>
+int Array<T, CheckPolicy, Alignment>::removeIf(Predicate pred)
+{
+  T *end = remove_if(ptr, ptr + lastIndex + 1, pred);
+  int removed = static_cast<int>(ptr + lastIndex + 1 - end);
+
+  lastIndex -= removed;
+  return removed;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+int Array<T, CheckPolicy, Alignment>::countItems() const
 {
   return lastIndex + 1;
 }
 
-template <typename T>
-int Array<T>::findIndex(T item) const
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+int Array<T, CheckPolicy, Alignment>::findIndex(const T &item) const
 {
+  // Integer and floating point items are searched with SIMD kernels
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::findFirst(ptr, lastIndex + 1, item);
+  }
+
   for (int i = 0; i <= lastIndex; i++)
   {
     if (ptr[i] == item)
@@ -188,8 +355,102 @@ int Array<T>::findIndex(T item) const
   return -1;
 }
 
-template <typename T>
-T Array<T>::getItem(int index) const
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+DynArray<int> Array<T, CheckPolicy, Alignment>::findAll(const T &item) const
+{
+  DynArray<int> indices;
+
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    simd::forEachMatch(ptr, lastIndex + 1, item, [&indices](int index)
+                       { indices.append(index); });
+    return indices;
+  }
+
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (ptr[i] == item)
+    {
+      indices.append(i);
+    }
+  }
+  return indices;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+int Array<T, CheckPolicy, Alignment>::count(const T &item) const
+{
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::count(ptr, lastIndex + 1, item);
+  }
+
+  int total = 0;
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (ptr[i] == item)
+    {
+      total++;
+    }
+  }
+  return total;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+bool Array<T, CheckPolicy, Alignment>::containsAny(const T *items, int size) const
+{
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::containsAny(ptr, lastIndex + 1, items, size);
+  }
+
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    for (int j = 0; j < size; j++)
+    {
+      if (ptr[i] == items[j])
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+#if __cplusplus >= 202002L
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+bool Array<T, CheckPolicy, Alignment>::containsAny(std::span<const T> items) const
+{
+  return containsAny(items.data(), static_cast<int>(items.size()));
+}
+#endif
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+T Array<T, CheckPolicy, Alignment>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+T &Array<T, CheckPolicy, Alignment>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+const T &Array<T, CheckPolicy, Alignment>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+T &Array<T, CheckPolicy, Alignment>::at(int index)
 {
   if (index < 0 || index > lastIndex)
   {
@@ -199,19 +460,27 @@ T Array<T>::getItem(int index) const
   return ptr[index];
 }
 
-template <typename T>
-void Array<T>::replace(T item, int index)
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+const T &Array<T, CheckPolicy, Alignment>::at(int index) const
 {
   if (index < 0 || index > lastIndex)
   {
     throw out_of_range("Index is out of range.");
   }
 
+  return ptr[index];
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::replace(T item, int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
   ptr[index] = item;
 }
 
-template <typename T>
-void Array<T>::display() const{
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+void Array<T, CheckPolicy, Alignment>::display() const{
   cout<<"[";
   for (int i = 0; i <= lastIndex; i++)
   {
@@ -223,6 +492,52 @@ void Array<T>::display() const{
   }
 }
 
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+T *Array<T, CheckPolicy, Alignment>::data()
+{
+  return ptr;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+const T *Array<T, CheckPolicy, Alignment>::data() const
+{
+  return ptr;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+int Array<T, CheckPolicy, Alignment>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+typename Array<T, CheckPolicy, Alignment>::iterator Array<T, CheckPolicy, Alignment>::begin()
+{
+  return ptr;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+typename Array<T, CheckPolicy, Alignment>::iterator Array<T, CheckPolicy, Alignment>::end()
+{
+  return ptr + lastIndex + 1;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+typename Array<T, CheckPolicy, Alignment>::const_iterator Array<T, CheckPolicy, Alignment>::begin() const
+{
+  return ptr;
+}
+
+template <typename T, typename CheckPolicy, std::size_t Alignment>
+typename Array<T, CheckPolicy, Alignment>::const_iterator Array<T, CheckPolicy, Alignment>::end() const
+{
+  return ptr + lastIndex + 1;
+}
+
+#if __cplusplus >= 202002L
+static_assert(std::ranges::contiguous_range<Array<int>>);
+#endif
+
 int main(){
   Array<int> arr(5);
   arr.append(10);
@@ -0,0 +1,369 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef ARRAY_IO_HPP
+
+#define ARRAY_IO_HPP
+
+// Binary array files: a 64 byte header followed by the raw items, the same
+// layout MmapArray keeps on disk, so a dump written by DynArray::writeTo can
+// be mapped with MmapArray and an MmapArray file read with readFrom.
+//
+// Items are copied between memory and the file descriptor as bytes with as
+// few system calls as the kernel allows, so only trivially copyable types can
+// be stored, and files are only portable between machines of the same byte
+// order. ArrayWriter and ArrayReader stream an array in chunks for data that
+// does not fit in memory at once.
+namespace io
+{
+  struct FileHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t itemSize;
+    std::uint64_t count;
+  };
+
+  const char MAGIC[8] = {'D', 'Y', 'N', 'A', 'R', 'R', 'A', 'Y'};
+  const std::uint32_t VERSION = 1;
+
+  // Items start on their own cache line after the header
+  const std::size_t DATA_OFFSET = 64;
+
+  // Count of a stream whose length was not known when its header was
+  // written (e.g. to a pipe); the items then run until the end of the file
+  const std::uint64_t UNKNOWN_COUNT = ~static_cast<std::uint64_t>(0);
+
+  [[noreturn]] inline void fail(const char *msg)
+  {
+    throw std::system_error(errno, std::generic_category(), msg);
+  }
+
+  // Writes every byte of the given parts, resuming after partial writes and
+  // signals
+  inline void writeFully(int fd, iovec *parts, int count)
+  {
+    while (count > 0)
+    {
+      ssize_t written = ::writev(fd, parts, count);
+      if (written < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        fail("Cannot write the array");
+      }
+
+      std::size_t left = static_cast<std::size_t>(written);
+      while (count > 0 && left >= parts->iov_len)
+      {
+        left -= parts->iov_len;
+        parts++;
+        count--;
+      }
+
+      if (count > 0)
+      {
+        parts->iov_base = static_cast<char *>(parts->iov_base) + left;
+        parts->iov_len -= left;
+      }
+    }
+  }
+
+  // Reads until 'bytes' bytes arrived or the file ended and returns how
+  // many arrived
+  inline std::size_t readFully(int fd, void *dest, std::size_t bytes)
+  {
+    std::size_t done = 0;
+
+    while (done < bytes)
+    {
+      ssize_t got = ::read(fd, static_cast<char *>(dest) + done, bytes - done);
+      if (got < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        fail("Cannot read the array");
+      }
+
+      if (got == 0)
+      {
+        break;
+      }
+      done += static_cast<std::size_t>(got);
+    }
+
+    return done;
+  }
+
+  // Fills the first DATA_OFFSET bytes of a file for items of type T
+  template <typename T>
+  void makeHeader(char *block, std::uint64_t count)
+  {
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.itemSize = sizeof(T);
+    header.count = count;
+
+    std::memset(block, 0, DATA_OFFSET);
+    std::memcpy(block, &header, sizeof(header));
+  }
+
+  // Writes the header and the items with a single writev()
+  template <typename T>
+  void writeArray(int fd, const T *items, int count)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable items can be written as bytes.");
+
+    char header[DATA_OFFSET];
+    makeHeader<T>(header, static_cast<std::uint64_t>(count));
+
+    iovec parts[2];
+    parts[0].iov_base = header;
+    parts[0].iov_len = DATA_OFFSET;
+    parts[1].iov_base = const_cast<T *>(items);
+    parts[1].iov_len = static_cast<std::size_t>(count) * sizeof(T);
+
+    writeFully(fd, parts, count > 0 ? 2 : 1);
+  }
+
+  // Writes an array of unknown length chunk by chunk. The count in the
+  // header is filled in by finish() when the file descriptor is seekable and
+  // not in O_APPEND mode; otherwise readers take the items up to the end of
+  // the stream.
+  template <typename T>
+  class ArrayWriter
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable items can be written as bytes.");
+
+  private:
+    int fd;
+    off_t start;
+    std::uint64_t written;
+    bool finished;
+
+    // Offset the header is written at, or -1 if it cannot be patched later
+    static off_t headerOffset(int);
+
+  public:
+    // Writes the header at the current position of the file descriptor
+    explicit ArrayWriter(int);
+
+    // Finishes the file if finish() was not called; errors are ignored
+    // since the file stays readable without the count
+    ~ArrayWriter();
+    ArrayWriter(const ArrayWriter &) = delete;
+    ArrayWriter &operator=(const ArrayWriter &) = delete;
+
+    void write(const T *, int);
+
+    // Stores the number of items written in the header
+    void finish();
+
+    std::uint64_t countItems() const;
+  };
+
+  template <typename T>
+  off_t ArrayWriter<T>::headerOffset(int fd)
+  {
+    // With O_APPEND every write, pwrite included on Linux, goes to the end
+    // of the file, so the current offset is not where the header lands and
+    // the header could not be patched in place
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags == -1 || (flags & O_APPEND) != 0)
+    {
+      return -1;
+    }
+
+    return ::lseek(fd, 0, SEEK_CUR);
+  }
+
+  template <typename T>
+  ArrayWriter<T>::ArrayWriter(int fd) : fd(fd), start(headerOffset(fd)), written(0), finished(false)
+  {
+    char header[DATA_OFFSET];
+    makeHeader<T>(header, UNKNOWN_COUNT);
+
+    iovec part;
+    part.iov_base = header;
+    part.iov_len = DATA_OFFSET;
+    writeFully(fd, &part, 1);
+  }
+
+  template <typename T>
+  ArrayWriter<T>::~ArrayWriter()
+  {
+    try
+    {
+      finish();
+    }
+    catch (...)
+    {
+    }
+  }
+
+  template <typename T>
+  void ArrayWriter<T>::write(const T *items, int count)
+  {
+    if (finished)
+    {
+      throw std::logic_error("Cannot write to a finished array file.");
+    }
+
+    if (count <= 0)
+    {
+      return;
+    }
+
+    iovec part;
+    part.iov_base = const_cast<T *>(items);
+    part.iov_len = static_cast<std::size_t>(count) * sizeof(T);
+    writeFully(fd, &part, 1);
+
+    written += static_cast<std::uint64_t>(count);
+  }
+
+  template <typename T>
+  void ArrayWriter<T>::finish()
+  {
+    if (finished)
+    {
+      return;
+    }
+    finished = true;
+
+    // A pipe, a socket or an O_APPEND file keeps UNKNOWN_COUNT in its header
+    if (start < 0)
+    {
+      return;
+    }
+
+    off_t at = start + static_cast<off_t>(offsetof(FileHeader, count));
+    if (::pwrite(fd, &written, sizeof(written), at) != static_cast<ssize_t>(sizeof(written)))
+    {
+      fail("Cannot write the array count");
+    }
+  }
+
+  template <typename T>
+  std::uint64_t ArrayWriter<T>::countItems() const
+  {
+    return written;
+  }
+
+  // Reads an array file chunk by chunk, starting at the current position of
+  // the file descriptor
+  template <typename T>
+  class ArrayReader
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable items can be read as bytes.");
+
+  private:
+    int fd;
+    std::uint64_t remaining;
+    bool done;
+
+  public:
+    // Reads and checks the header
+    explicit ArrayReader(int);
+    ArrayReader(const ArrayReader &) = delete;
+    ArrayReader &operator=(const ArrayReader &) = delete;
+
+    // Reads up to 'max' items into raw storage and returns how many were read
+    int read(T *, int);
+
+    // True once every item has been read
+    bool isDone() const;
+
+    // Items left to read, or UNKNOWN_COUNT for a stream without a count
+    std::uint64_t countRemaining() const;
+  };
+
+  template <typename T>
+  ArrayReader<T>::ArrayReader(int fd) : fd(fd), remaining(0), done(false)
+  {
+    char block[DATA_OFFSET];
+    if (readFully(fd, block, DATA_OFFSET) != DATA_OFFSET)
+    {
+      throw std::runtime_error("File is too small to be an array file.");
+    }
+
+    FileHeader header;
+    std::memcpy(&header, block, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.itemSize != sizeof(T))
+    {
+      throw std::runtime_error("File is not an array file of this item type.");
+    }
+
+    remaining = header.count;
+    done = remaining == 0;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Lets the kernel read ahead more aggressively; fails harmlessly on pipes
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+
+  template <typename T>
+  int ArrayReader<T>::read(T *dest, int max)
+  {
+    if (done || max <= 0)
+    {
+      return 0;
+    }
+
+    std::uint64_t wanted = static_cast<std::uint64_t>(max);
+    if (remaining != UNKNOWN_COUNT && remaining < wanted)
+    {
+      wanted = remaining;
+    }
+
+    std::size_t bytes = static_cast<std::size_t>(wanted) * sizeof(T);
+    std::size_t got = readFully(fd, dest, bytes);
+
+    if (got % sizeof(T) != 0 || (got < bytes && remaining != UNKNOWN_COUNT))
+    {
+      throw std::runtime_error("Array file ends in the middle of its items.");
+    }
+
+    std::uint64_t items = got / sizeof(T);
+    if (remaining != UNKNOWN_COUNT)
+    {
+      remaining -= items;
+      done = remaining == 0;
+    }
+    else
+    {
+      done = got < bytes;
+    }
+
+    return static_cast<int>(items);
+  }
+
+  template <typename T>
+  bool ArrayReader<T>::isDone() const
+  {
+    return done;
+  }
+
+  template <typename T>
+  std::uint64_t ArrayReader<T>::countRemaining() const
+  {
+    return remaining;
+  }
+}
+
+#endif
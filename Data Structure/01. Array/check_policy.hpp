@@ -0,0 +1,41 @@
+#include <cassert>
+#include <stdexcept>
+
+#ifndef CHECK_POLICY_HPP
+
+#define CHECK_POLICY_HPP
+
+// Range check policies for element access (getItem, replace, operator[]).
+// at() always throws, whatever policy the container uses.
+
+// Throws std::out_of_range on an invalid index
+struct Checked
+{
+  static constexpr void check(bool isValid, const char *msg)
+  {
+    if (!isValid)
+    {
+      throw std::out_of_range(msg);
+    }
+  }
+};
+
+// No check at all, for hot loops whose indices are already known to be valid
+struct Unchecked
+{
+  static constexpr void check(bool, const char *)
+  {
+  }
+};
+
+// Asserts in debug builds and compiles to nothing when NDEBUG is defined
+struct DebugAssert
+{
+  static constexpr void check(bool isValid, const char *)
+  {
+    assert(isValid);
+    (void)isValid;
+  }
+};
+
+#endif
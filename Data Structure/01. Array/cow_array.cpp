@@ -0,0 +1,248 @@
+#ifndef COW_ARRAY_CPP
+
+#define COW_ARRAY_CPP
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include "dynamic_array.cpp"
+
+// Copy-on-write handle for Array or DynArray (e.g. CowArray<DynArray<int>>).
+// Copies share one reference counted buffer, so handing a snapshot to another
+// thread is O(1). The first mutating call on a shared handle clones the buffer
+// and leaves the other handles untouched. The count is atomic, so handles to
+// the same buffer can be copied, read and dropped from different threads; a
+// single handle is not safe to share between threads.
+template <typename Container>
+class CowArray
+{
+private:
+  struct Block
+  {
+    std::atomic<int> refs;
+    Container items;
+
+    explicit Block(const Container &source) : refs(1), items(source) {}
+  };
+
+  // Never null; copying a handle is a single atomic increment, so there is
+  // no separate move
+  Block *block;
+
+  void release();
+
+  // Gives this handle its own copy of the items if the buffer is shared
+  void detach();
+
+public:
+  using value_type = typename Container::value_type;
+  using const_iterator = typename Container::const_iterator;
+
+  // Only for default constructible containers; Array has no default size,
+  // so CowArray<Array<T>> must be built from an existing Array
+  CowArray();
+  explicit CowArray(const Container &);
+  ~CowArray();
+  CowArray(const CowArray &) noexcept;
+  CowArray &operator=(const CowArray &) noexcept;
+
+  void append(const value_type &);
+  void insert(const value_type &, int);
+  void remove(int);
+  void replace(const value_type &, int);
+
+  // Mutable access to the whole container for anything else; clones the
+  // buffer first if it is shared
+  Container &edit();
+
+  // Read-only access never clones
+  const Container &view() const;
+  value_type getItem(int) const;
+  const value_type &operator[](int) const;
+  const value_type &at(int) const;
+  int findIndex(const value_type &) const;
+  bool isEmpty() const;
+  int countItems() const;
+
+  // True if another handle shares the buffer
+  bool isShared() const;
+
+  const value_type *data() const;
+  int size() const;
+  const_iterator begin() const;
+  const_iterator end() const;
+};
+
+template <typename Container>
+CowArray<Container>::CowArray() : block(nullptr)
+{
+  static_assert(std::is_default_constructible<Container>::value,
+                "This container has no default constructor; build the CowArray from an existing one.");
+
+  block = new Block(Container());
+}
+
+template <typename Container>
+CowArray<Container>::CowArray(const Container &items) : block(new Block(items))
+{
+}
+
+template <typename Container>
+CowArray<Container>::~CowArray()
+{
+  release();
+}
+
+template <typename Container>
+CowArray<Container>::CowArray(const CowArray &obj) noexcept : block(obj.block)
+{
+  // A new reference only needs to be counted; it orders nothing
+  block->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Container>
+CowArray<Container> &CowArray<Container>::operator=(const CowArray &obj) noexcept
+{
+  if (block != obj.block)
+  {
+    obj.block->refs.fetch_add(1, std::memory_order_relaxed);
+    release();
+    block = obj.block;
+  }
+
+  return *this;
+}
+
+template <typename Container>
+void CowArray<Container>::release()
+{
+  // acq_rel so that the last owner sees every read the others made before
+  // it destroys the items
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    delete block;
+  }
+}
+
+template <typename Container>
+void CowArray<Container>::detach()
+{
+  if (block->refs.load(std::memory_order_acquire) == 1)
+  {
+    return;
+  }
+
+  // The old buffer stays alive for the other handles
+  Block *copy = new Block(block->items);
+  release();
+  block = copy;
+}
+
+template <typename Container>
+void CowArray<Container>::append(const value_type &item)
+{
+  detach();
+  block->items.append(item);
+}
+
+template <typename Container>
+void CowArray<Container>::insert(const value_type &item, int index)
+{
+  detach();
+  block->items.insert(item, index);
+}
+
+template <typename Container>
+void CowArray<Container>::remove(int index)
+{
+  detach();
+  block->items.remove(index);
+}
+
+template <typename Container>
+void CowArray<Container>::replace(const value_type &item, int index)
+{
+  detach();
+  block->items.replace(item, index);
+}
+
+template <typename Container>
+Container &CowArray<Container>::edit()
+{
+  detach();
+  return block->items;
+}
+
+template <typename Container>
+const Container &CowArray<Container>::view() const
+{
+  return block->items;
+}
+
+template <typename Container>
+typename CowArray<Container>::value_type CowArray<Container>::getItem(int index) const
+{
+  return block->items.getItem(index);
+}
+
+template <typename Container>
+const typename CowArray<Container>::value_type &CowArray<Container>::operator[](int index) const
+{
+  return view()[index];
+}
+
+template <typename Container>
+const typename CowArray<Container>::value_type &CowArray<Container>::at(int index) const
+{
+  return view().at(index);
+}
+
+template <typename Container>
+int CowArray<Container>::findIndex(const value_type &item) const
+{
+  return block->items.findIndex(item);
+}
+
+template <typename Container>
+bool CowArray<Container>::isEmpty() const
+{
+  return block->items.isEmpty();
+}
+
+template <typename Container>
+int CowArray<Container>::countItems() const
+{
+  return block->items.countItems();
+}
+
+template <typename Container>
+bool CowArray<Container>::isShared() const
+{
+  return block->refs.load(std::memory_order_acquire) > 1;
+}
+
+template <typename Container>
+const typename CowArray<Container>::value_type *CowArray<Container>::data() const
+{
+  return view().data();
+}
+
+template <typename Container>
+int CowArray<Container>::size() const
+{
+  return block->items.size();
+}
+
+template <typename Container>
+typename CowArray<Container>::const_iterator CowArray<Container>::begin() const
+{
+  return view().begin();
+}
+
+template <typename Container>
+typename CowArray<Container>::const_iterator CowArray<Container>::end() const
+{
+  return view().end();
+}
+
+#endif
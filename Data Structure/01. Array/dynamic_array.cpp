@@ -1,66 +1,501 @@
+#ifndef DYNAMIC_ARRAY_CPP
+
+#define DYNAMIC_ARRAY_CPP
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include "custom_exception"
+#include "check_policy.hpp"
+#include "simd_kernels.hpp"
+#include "aligned_memory.hpp"
+#include "parallel_sort.hpp"
+#include "radix_sort.hpp"
+#include "array_io.hpp"
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#include <span>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
+// Blocks of at least this many bytes are mapped straight from the kernel so
+// that growing them is an mremap() instead of a copy.
+#ifndef DYNARRAY_MMAP_THRESHOLD
+#define DYNARRAY_MMAP_THRESHOLD (64UL * 1024 * 1024)
+#endif
+
+// Types whose objects can be moved to a new address with a plain memcpy,
+// leaving nothing behind for the destructor. Trivially copyable types always
+// qualify; specialize this for others that do (e.g. most smart pointers).
 template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+// Growth policies decide the next capacity of a full DynArray.
+// grow(capacity, itemSize) must return a value greater than 'capacity'.
+// Capacities are clamped to INT_MAX, and growing a full INT_MAX array throws.
+inline void checkGrowth(int capacity)
+{
+  if (capacity >= INT_MAX)
+  {
+    throw std::length_error("Array cannot hold more than INT_MAX items.");
+  }
+}
+
+// Doubles the capacity on every growth
+struct DoublingGrowth
+{
+  static int grow(int capacity, std::size_t)
+  {
+    checkGrowth(capacity);
+    if (capacity < 1)
+    {
+      return 1;
+    }
+    return capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+  }
+};
+
+// Grows by 1.5x so that freed blocks can be reused by later growths
+struct OneAndHalfGrowth
+{
+  static int grow(int capacity, std::size_t)
+  {
+    checkGrowth(capacity);
+    if (capacity < 2)
+    {
+      return capacity + 1;
+    }
+    return capacity > INT_MAX - capacity / 2 ? INT_MAX : capacity + capacity / 2;
+  }
+};
+
+// Grows by 1.5x and then rounds the block up to the size class the
+// allocator would hand out anyway, so its slack becomes usable capacity.
+struct SizeClassGrowth
+{
+  static std::size_t sizeClass(std::size_t bytes)
+  {
+    // Tiny blocks come in 16-byte steps
+    if (bytes <= 128)
+    {
+      return (bytes + 15) & ~static_cast<std::size_t>(15);
+    }
+
+    // Large blocks are whole pages
+    if (bytes >= 64 * 1024)
+    {
+      return (bytes + 4095) & ~static_cast<std::size_t>(4095);
+    }
+
+    // In between, every power of two is split into four classes
+    std::size_t power = 128;
+    while (power * 2 < bytes)
+    {
+      power *= 2;
+    }
+
+    std::size_t step = power / 4;
+    return (bytes + step - 1) / step * step;
+  }
+
+  static int grow(int capacity, std::size_t itemSize)
+  {
+    int wanted = OneAndHalfGrowth::grow(capacity, itemSize);
+    std::size_t rounded = sizeClass(static_cast<std::size_t>(wanted) * itemSize) / itemSize;
+    return rounded > static_cast<std::size_t>(INT_MAX) ? INT_MAX : static_cast<int>(rounded);
+  }
+};
+
+// Alignment sets the alignment of the item block (e.g. 64 for cache-line
+// aligned vector loads); it is never less than alignof(T).
+template <typename T, typename GrowthPolicy = DoublingGrowth, typename CheckPolicy = Checked, std::size_t Alignment = alignof(T)>
 class DynArray
 {
+  static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
 private:
+  static constexpr std::size_t ALIGNMENT = Alignment < alignof(T) ? alignof(T) : Alignment;
+
   int capacity;
   int lastIndex;
+  bool autoShrink;
+  bool hugePages;
+
+  // Raw storage: only [0, lastIndex] holds constructed elements
   T *ptr;
 
+  // Both take the huge page flag the block is (to be) allocated with
+  static T *allocate(int, bool);
+  static void deallocate(T *, int, bool);
+
+  // True if a block of the given capacity is mmap-backed
+  static bool isMapped(int);
+
+  // Constructs copies of 'count' items of 'src' in raw storage at 'dest'.
+  // The copies are moves (or plain memcpy) unless T's move may throw, so the
+  // source survives a failure.
+  static void transfer(T *, int, T *);
+
+  // Ends the lifetime of items whose bytes were transferred
+  static void retire(T *, int);
+
+  // Moves the live elements into 'dest' and ends their lifetime in the old block
+  void relocateTo(T *);
+
+  // Moves the elements to a new block of the given capacity
+  void reallocate(int);
+  int nextCapacity() const;
+
+  // Halves the capacity (repeatedly) while auto-shrink is on and less than
+  // a quarter of it is in use
+  void shrinkIfSparse();
+
 protected:
   bool isFull() const;
   void clear();
 
 public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
   DynArray(int);
   DynArray();
   ~DynArray();
   DynArray(const DynArray &);
+  DynArray(DynArray &&) noexcept;
   DynArray &operator=(const DynArray &);
+  DynArray &operator=(DynArray &&) noexcept;
 
-  void append(T);
-  void insert(T, int);
+  void append(const T &);
+  void append(T &&);
+  void insert(const T &, int);
+  void insert(T &&, int);
   void remove(int);
-  void replace(T, int);
+  void replace(const T &, int);
+
+  // Inserts the items of [first, last) at the given index, shifting the tail
+  // once. The range must not point into this array.
+  template <typename InputIt>
+  void insertRange(int, InputIt, InputIt);
+
+  // Removes 'count' items starting at the given index
+  void removeRange(int, int);
+
+  // Removes every item for which the predicate is true in a single pass and
+  // returns how many were removed
+  template <typename Predicate>
+  int removeIf(Predicate);
+
+  // Multithreaded sorts; 'threads' = 0 uses every hardware thread
+  template <typename Compare = std::less<T>>
+  void sort(Compare = Compare(), int = 0);
+
+  template <typename Compare = std::less<T>>
+  void stableSort(Compare = Compare(), int = 0);
+
+  // Stable single threaded radix sort of integer or floating point items in
+  // ascending order, usually well ahead of sort() on one thread
+  void radixSort();
+
+  // Stable radix sort by the integer or floating point key that key(item)
+  // returns; the items must be trivially copyable
+  template <typename KeyFn>
+  void sortByKey(KeyFn);
+
+  // Sorts the 'count' smallest items into the front; the order of the rest
+  // is unspecified
+  template <typename Compare = std::less<T>>
+  void partialSort(int, Compare = Compare(), int = 0);
+
+  // Binary I/O for trivially copyable items (see array_io.hpp). writeTo()
+  // sends the header and the raw items with one writev(); readFrom()
+  // replaces the items with the ones in the file, read straight into the
+  // reserved block.
+  void writeTo(int) const;
+  void readFrom(int);
+
+  // Streaming: writeTo() appends the items to the stream, readFrom()
+  // replaces them with the next chunk of at most the given number of items
+  // and returns how many were read
+  void writeTo(io::ArrayWriter<T> &) const;
+  int readFrom(io::ArrayReader<T> &, int);
+
   void doubleArray();
   void halfArray();
 
+  // Grows the capacity to at least the given number of items
+  void reserve(int);
+
+  // Releases the capacity that is not used by any item
+  void shrink_to_fit();
+
+  // When enabled, remove() halves the capacity once less than a quarter of
+  // it is in use. The gap between the 1/4 and 1/2 marks keeps append/remove
+  // near a boundary from reallocating every time.
+  void setAutoShrink(bool);
+
+  // When enabled, blocks of 2 MiB or more are aligned to a huge page and
+  // marked with madvise(MADV_HUGEPAGE), cutting TLB misses on big scans.
+  // The current block is moved right away to follow the new setting.
+  void setHugePages(bool);
+
+  // Constructs an item in place at the end of the array
+  template <typename... Args>
+  T &emplace_back(Args &&...);
+
+  // Constructs an item in place at the given index
+  template <typename... Args>
+  T &emplace(int, Args &&...);
+
   bool isEmpty() const;
   int countItems() const;
   T getItem(int) const;
-  int findIndex(T) const;
+
+  // Reference access; operator[] follows CheckPolicy, at() always throws
+  T &operator[](int);
+  const T &operator[](int) const;
+  T &at(int);
+  const T &at(int) const;
+
+  int findIndex(const T &) const;
+
+  // Indices of all items equal to the given one
+  DynArray<int> findAll(const T &) const;
+
+  // Number of items equal to the given one
+  int count(const T &) const;
+
+  // True if any item equals one of the given values
+  bool containsAny(const T *, int) const;
+#if __cplusplus >= 202002L
+  bool containsAny(std::span<const T>) const;
+#endif
+
   int getCapacity() const;
+
+  // Raw pointer to the items, valid until the next reallocation
+  T *data();
+  const T *data() const;
+  int size() const;
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
 };
 
-template <typename T>
-DynArray<T>::DynArray(int initialSize)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::isMapped(int size)
+{
+#ifdef __linux__
+  // mremap() moves bytes, so only relocatable types may live in a mapping,
+  // and a mapping is only page aligned
+  return IsTriviallyRelocatable<T>::value && ALIGNMENT <= 4096 &&
+         static_cast<std::size_t>(size) * sizeof(T) >= DYNARRAY_MMAP_THRESHOLD;
+#else
+  return false;
+#endif
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+T *DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::allocate(int size, bool huge)
+{
+  std::size_t bytes = static_cast<std::size_t>(size) * sizeof(T);
+
+#ifdef __linux__
+  if (isMapped(size))
+  {
+    void *block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+
+    if (memory::usesHugePages(bytes, huge))
+    {
+      memory::adviseHugePages(block, bytes);
+    }
+    return static_cast<T *>(block);
+  }
+#endif
+
+  return static_cast<T *>(memory::allocate(bytes, ALIGNMENT, huge));
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::deallocate(T *block, int size, bool huge)
+{
+#ifdef __linux__
+  if (isMapped(size))
+  {
+    munmap(block, static_cast<std::size_t>(size) * sizeof(T));
+    return;
+  }
+#endif
+
+  memory::deallocate(block, static_cast<std::size_t>(size) * sizeof(T), ALIGNMENT, huge);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::transfer(T *src, int count, T *dest)
+{
+  if constexpr (IsTriviallyRelocatable<T>::value)
+  {
+    if (count > 0)
+    {
+      std::memcpy(static_cast<void *>(dest), static_cast<const void *>(src), count * sizeof(T));
+    }
+  }
+  else if constexpr (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+  {
+    std::uninitialized_move_n(src, count, dest);
+  }
+  else
+  {
+    std::uninitialized_copy_n(src, count, dest);
+  }
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::retire(T *src, int count)
+{
+  // Relocated bytes now belong to the new block
+  if constexpr (!IsTriviallyRelocatable<T>::value)
+  {
+    std::destroy_n(src, count);
+  }
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::relocateTo(T *dest)
+{
+  transfer(ptr, lastIndex + 1, dest);
+  retire(ptr, lastIndex + 1);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::shrinkIfSparse()
+{
+  if (!autoShrink)
+  {
+    return;
+  }
+
+  int newCapacity = capacity;
+  while (newCapacity > 1 && lastIndex + 1 < newCapacity / 4)
+  {
+    newCapacity /= 2;
+  }
+
+  if (newCapacity != capacity)
+  {
+    reallocate(newCapacity);
+  }
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::reallocate(int newCapacity)
+{
+#ifdef __linux__
+  // Let the kernel move the page tables instead of copying the bytes
+  if (isMapped(capacity) && isMapped(newCapacity))
+  {
+    void *block = mremap(ptr, static_cast<std::size_t>(capacity) * sizeof(T),
+                         static_cast<std::size_t>(newCapacity) * sizeof(T), MREMAP_MAYMOVE);
+    if (block == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+
+    if (memory::usesHugePages(static_cast<std::size_t>(newCapacity) * sizeof(T), hugePages))
+    {
+      memory::adviseHugePages(block, static_cast<std::size_t>(newCapacity) * sizeof(T));
+    }
+
+    ptr = static_cast<T *>(block);
+    capacity = newCapacity;
+    return;
+  }
+#endif
+
+  T *temp = allocate(newCapacity, hugePages);
+
+  try
+  {
+    relocateTo(temp);
+  }
+  catch (...)
+  {
+    deallocate(temp, newCapacity, hugePages);
+    throw;
+  }
+
+  deallocate(ptr, capacity, hugePages);
+
+  ptr = temp;
+  capacity = newCapacity;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::nextCapacity() const
+{
+  return GrowthPolicy::grow(capacity, sizeof(T));
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::DynArray(int initialSize)
 {
   // Set capacity to 1 if initial size is less than 1
   capacity = initialSize < 1 ? 1 : initialSize;
   lastIndex = -1;
+  autoShrink = false;
+  hugePages = false;
 
-  ptr = new T[capacity];
+  ptr = allocate(capacity, hugePages);
 }
 
-template <typename T>
-DynArray<T>::DynArray()
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::DynArray()
 {
   capacity = 1;
   lastIndex = -1;
-  ptr = new T[capacity];
+  autoShrink = false;
+  hugePages = false;
+  ptr = allocate(capacity, hugePages);
 }
 
-template <typename T>
-DynArray<T>::~DynArray()
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::~DynArray()
 {
   clear();
 }
 
-template <typename T>
-DynArray<T>::DynArray(const DynArray &obj)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::DynArray(const DynArray &obj)
 {
   if (this == &obj)
   {
@@ -69,164 +504,643 @@ DynArray<T>::DynArray(const DynArray &obj)
 
   capacity = obj.capacity;
   lastIndex = obj.lastIndex;
-  ptr = new T[capacity];
+  autoShrink = obj.autoShrink;
+  hugePages = obj.hugePages;
+  ptr = allocate(capacity, hugePages);
 
-  for (int i = 0; i <= lastIndex; i++)
+  try
   {
-    ptr[i] = obj.ptr[i];
+    std::uninitialized_copy_n(obj.ptr, lastIndex + 1, ptr);
+  }
+  catch (...)
+  {
+    deallocate(ptr, capacity, hugePages);
+    throw;
   }
 }
 
-template <typename T>
-DynArray<T> &DynArray<T>::operator=(const DynArray &obj)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::DynArray(DynArray &&obj) noexcept
+    : capacity(obj.capacity), lastIndex(obj.lastIndex), autoShrink(obj.autoShrink), hugePages(obj.hugePages), ptr(obj.ptr)
+{
+  obj.capacity = 0;
+  obj.lastIndex = -1;
+  obj.ptr = nullptr;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment> &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::operator=(const DynArray &obj)
 {
   if (this != &obj)
   {
+    // Copy first so that a throwing copy leaves this array untouched
+    T *temp = allocate(obj.capacity, obj.hugePages);
+
+    try
+    {
+      std::uninitialized_copy_n(obj.ptr, obj.lastIndex + 1, temp);
+    }
+    catch (...)
+    {
+      deallocate(temp, obj.capacity, obj.hugePages);
+      throw;
+    }
+
+    // Takes the settings of the other array, as the copy constructor does
     clear();
     capacity = obj.capacity;
     lastIndex = obj.lastIndex;
-    ptr = new T[capacity];
-  
-    for (int i = 0; i <= lastIndex; i++)
-    {
-      ptr[i] = obj.ptr[i];
-    }
+    autoShrink = obj.autoShrink;
+    hugePages = obj.hugePages;
+    ptr = temp;
   }
 
   return *this;
 }
 
-template <typename T>
-void DynArray<T>::clear()
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<T, GrowthPolicy, CheckPolicy, Alignment> &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::operator=(DynArray &&obj) noexcept
+{
+  if (this != &obj)
+  {
+    clear();
+    capacity = obj.capacity;
+    lastIndex = obj.lastIndex;
+    autoShrink = obj.autoShrink;
+    hugePages = obj.hugePages;
+    ptr = obj.ptr;
+
+    obj.capacity = 0;
+    obj.lastIndex = -1;
+    obj.ptr = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::clear()
 {
   if (ptr != nullptr)
   {
-    delete[] ptr;
-    ptr = nullptr
+    std::destroy_n(ptr, lastIndex + 1);
+    deallocate(ptr, capacity, hugePages);
+    ptr = nullptr;
   }
+
+  lastIndex = -1;
 }
 
-template <typename T>
-void DynArray<T>::append(T item)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename... Args>
+T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::emplace_back(Args &&...args)
 {
-  if (isFull())
+  if (!isFull())
+  {
+    ::new (static_cast<void *>(ptr + lastIndex + 1)) T(std::forward<Args>(args)...);
+    lastIndex++;
+    return ptr[lastIndex];
+  }
+
+  int newCapacity = nextCapacity();
+
+  // A remapped block may move, so build the item before growing in case the
+  // arguments refer to an element of this array.
+  if (isMapped(capacity) && isMapped(newCapacity))
+  {
+    T item(std::forward<Args>(args)...);
+    reallocate(newCapacity);
+    ::new (static_cast<void *>(ptr + lastIndex + 1)) T(std::move(item));
+    lastIndex++;
+    return ptr[lastIndex];
+  }
+
+  // For the same reason the new item is built in the new block before the
+  // old elements are relocated.
+  T *temp = allocate(newCapacity, hugePages);
+
+  try
+  {
+    ::new (static_cast<void *>(temp + lastIndex + 1)) T(std::forward<Args>(args)...);
+  }
+  catch (...)
   {
-    doubleArray();
+    deallocate(temp, newCapacity, hugePages);
+    throw;
   }
 
+  try
+  {
+    relocateTo(temp);
+  }
+  catch (...)
+  {
+    temp[lastIndex + 1].~T();
+    deallocate(temp, newCapacity, hugePages);
+    throw;
+  }
+
+  deallocate(ptr, capacity, hugePages);
+
+  ptr = temp;
+  capacity = newCapacity;
   lastIndex++;
-  ptr[lastIndex] = item;
+  return ptr[lastIndex];
 }
 
-template <typename T>
-void DynArray<T>::insert(T item, int index)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename... Args>
+T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::emplace(int index, Args &&...args)
 {
   if (index < 0 || index > lastIndex + 1)
   {
     throw out_of_range("Index of array is out of range.");
   }
 
+  if (index == lastIndex + 1)
+  {
+    return emplace_back(std::forward<Args>(args)...);
+  }
+
+  // Build the item before shifting since the arguments may alias an element
+  T item(std::forward<Args>(args)...);
+
   if (isFull())
   {
-    doubleArray();
+    reallocate(nextCapacity());
   }
 
-  // Shift each digit to one step right side
-  for (int i = lastIndex; i >= 0; i--)
+  // The last element moves into raw storage, the rest shift one step right
+  ::new (static_cast<void *>(ptr + lastIndex + 1)) T(std::move(ptr[lastIndex]));
+  lastIndex++;
+
+  for (int i = lastIndex - 1; i > index; i--)
   {
-    ptr[i + 1] = ptr[i];
+    ptr[i] = std::move(ptr[i - 1]);
   }
 
+  ptr[index] = std::move(item);
+  return ptr[index];
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::append(const T &item)
+{
+  emplace_back(item);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::append(T &&item)
+{
+  emplace_back(std::move(item));
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::insert(const T &item, int index)
+{
+  emplace(index, item);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::insert(T &&item, int index)
+{
+  emplace(index, std::move(item));
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::replace(const T &item, int index)
+{
+
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
   ptr[index] = item;
-  lastIndex++;
 }
 
-template <typename T>
-void DynArray<T>::replace(T item, int index)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::remove(int index)
 {
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
 
-  if (index < 0 || index > lastIndex + 1)
+  if (index < 0 || index > lastIndex)
   {
     throw out_of_range("Index of array is out of range.");
   }
 
-  ptr[index] = item;
+  // Shift each item to one left side
+  for (int i = index; i < lastIndex; i++)
+  {
+    ptr[i] = std::move(ptr[i + 1]);
+  }
+
+  ptr[lastIndex].~T();
+  lastIndex--;
+
+  shrinkIfSparse();
 }
 
-template <typename T>
-void DynArray<T>::remove(int index)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename InputIt>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::insertRange(int index, InputIt first, InputIt last)
 {
   if (index < 0 || index > lastIndex + 1)
   {
     throw out_of_range("Index of array is out of range.");
   }
 
-  // Shift each digit to one left side
-  for (int i = index; i < lastIndex; i++)
+  using Category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (!std::is_base_of<std::forward_iterator_tag, Category>::value)
   {
-    ptr[i] = ptr[i + 1];
+    // A single pass range has to be counted before the tail can move
+    DynArray items;
+    for (; first != last; ++first)
+    {
+      items.append(*first);
+    }
+    insertRange(index, std::make_move_iterator(items.ptr), std::make_move_iterator(items.ptr + items.countItems()));
+    return;
   }
+  else
+  {
+    int count = static_cast<int>(std::distance(first, last));
+    int size = lastIndex + 1;
+    int tail = size - index;
 
-  lastIndex--;
+    if (count == 0)
+    {
+      return;
+    }
+
+    if (size + count > capacity)
+    {
+      // Build the new block around the inserted items: head and tail are
+      // relocated straight to their final places
+      int newCapacity = nextCapacity();
+      if (newCapacity < size + count)
+      {
+        newCapacity = size + count;
+      }
+
+      T *temp = allocate(newCapacity, hugePages);
+      try
+      {
+        std::uninitialized_copy(first, last, temp + index);
+      }
+      catch (...)
+      {
+        deallocate(temp, newCapacity, hugePages);
+        throw;
+      }
+
+      try
+      {
+        transfer(ptr, index, temp);
+        try
+        {
+          transfer(ptr + index, tail, temp + index + count);
+        }
+        catch (...)
+        {
+          std::destroy_n(temp, index);
+          throw;
+        }
+      }
+      catch (...)
+      {
+        std::destroy_n(temp + index, count);
+        deallocate(temp, newCapacity, hugePages);
+        throw;
+      }
+
+      retire(ptr, size);
+      deallocate(ptr, capacity, hugePages);
+      ptr = temp;
+      capacity = newCapacity;
+      lastIndex += count;
+      return;
+    }
+
+    if constexpr (IsTriviallyRelocatable<T>::value)
+    {
+      // One memmove opens the gap; undo it if a copy throws
+      std::memmove(static_cast<void *>(ptr + index + count), static_cast<const void *>(ptr + index), tail * sizeof(T));
+      try
+      {
+        std::uninitialized_copy(first, last, ptr + index);
+      }
+      catch (...)
+      {
+        std::memmove(static_cast<void *>(ptr + index), static_cast<const void *>(ptr + index + count), tail * sizeof(T));
+        throw;
+      }
+    }
+    else
+    {
+      // Items landing past the current end go to raw storage, the rest are
+      // shifted by one move_backward over constructed slots
+      int split = index > size - count ? index : size - count;
+      std::uninitialized_move(ptr + split, ptr + size, ptr + split + count);
+      std::move_backward(ptr + index, ptr + split, ptr + split + count);
+
+      // Slots below the old end are constructed (moved-from), the others are raw
+      int assigned = tail < count ? tail : count;
+      InputIt middle = std::next(first, assigned);
+      try
+      {
+        std::copy(first, middle, ptr + index);
+        std::uninitialized_copy(middle, last, ptr + size);
+      }
+      catch (...)
+      {
+        // Move the tail back over the gap and end the slots past the old
+        // end that the shift constructed
+        std::move(ptr + index + count, ptr + size + count, ptr + index);
+        std::destroy_n(ptr + split + count, size - split);
+        throw;
+      }
+    }
+
+    lastIndex += count;
+  }
 }
 
-template <typename T>
-bool DynArray<T>::isEmpty() const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::removeRange(int index, int count)
+{
+  if (index < 0 || count < 0 || index + count > lastIndex + 1)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  if (count == 0)
+  {
+    return;
+  }
+
+  int size = lastIndex + 1;
+
+  if constexpr (IsTriviallyRelocatable<T>::value)
+  {
+    std::destroy_n(ptr + index, count);
+    std::memmove(static_cast<void *>(ptr + index), static_cast<const void *>(ptr + index + count), (size - index - count) * sizeof(T));
+  }
+  else
+  {
+    std::move(ptr + index + count, ptr + size, ptr + index);
+    std::destroy_n(ptr + size - count, count);
+  }
+
+  lastIndex -= count;
+  shrinkIfSparse();
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename Predicate>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::removeIf(Predicate pred)
+{
+  // Kept items are compacted to the front, the leftovers are destroyed
+  T *end = std::remove_if(ptr, ptr + lastIndex + 1, pred);
+  int removed = static_cast<int>(ptr + lastIndex + 1 - end);
+
+  std::destroy_n(end, removed);
+  lastIndex -= removed;
+  shrinkIfSparse();
+
+  return removed;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename Compare>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::sort(Compare comp, int threads)
+{
+  parallel::sort(ptr, lastIndex + 1, comp, threads);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename Compare>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::stableSort(Compare comp, int threads)
+{
+  parallel::stableSort(ptr, lastIndex + 1, comp, threads);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::radixSort()
+{
+  radix::sort(ptr, lastIndex + 1);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename KeyFn>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::sortByKey(KeyFn key)
+{
+  radix::sortByKey(ptr, lastIndex + 1, key);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+template <typename Compare>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::partialSort(int count, Compare comp, int threads)
+{
+  if (count < 0 || count > lastIndex + 1)
+  {
+    throw out_of_range("Count of items is out of range.");
+  }
+
+  parallel::partialSort(ptr, lastIndex + 1, count, comp, threads);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::isEmpty() const
 {
   return lastIndex == -1;
 }
 
-template <typename T>
-bool DynArray<T>::isFull() const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::isFull() const
 {
   return lastIndex + 1 == capacity;
 }
 
-template <typename T>
-void DynArray<T>::doubleArray()
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::writeTo(int fd) const
 {
-  capacity *= 2;
-  T *temp = new T[capacity];
+  io::writeArray(fd, ptr, lastIndex + 1);
+}
 
-  for (int i = 0; i <= lastIndex; i++)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::readFrom(int fd)
+{
+  io::ArrayReader<T> reader(fd);
+  std::uint64_t count = reader.countRemaining();
+
+  if (count != io::UNKNOWN_COUNT && count > static_cast<std::uint64_t>(INT_MAX))
   {
-    temp[i] = ptr[i];
+    throw std::length_error("Array file holds more items than an array can.");
   }
 
-  delete[] ptr;
-  ptr = temp;
+  // Trivially copyable items need no destructor call
+  lastIndex = -1;
+
+  if (count != io::UNKNOWN_COUNT)
+  {
+    reserve(static_cast<int>(count));
+  }
+
+  try
+  {
+    // A file with a count fits the reserved block in one read; a stream
+    // without one grows the block until it ends
+    while (!reader.isDone())
+    {
+      if (isFull())
+      {
+        doubleArray();
+      }
+      lastIndex += reader.read(ptr + lastIndex + 1, capacity - lastIndex - 1);
+    }
+  }
+  catch (...)
+  {
+    lastIndex = -1;
+    throw;
+  }
 }
 
-template <typename T>
-void DynArray<T>::halfArray()
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::writeTo(io::ArrayWriter<T> &writer) const
+{
+  writer.write(ptr, lastIndex + 1);
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::readFrom(io::ArrayReader<T> &reader, int maxItems)
+{
+  lastIndex = -1;
+  reserve(maxItems);
+
+  try
+  {
+    lastIndex = reader.read(ptr, maxItems) - 1;
+  }
+  catch (...)
+  {
+    lastIndex = -1;
+    throw;
+  }
+
+  return lastIndex + 1;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::doubleArray()
 {
-  if (capacity == 1)
+  reallocate(nextCapacity());
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::halfArray()
+{
+  // Never drop live items while shrinking
+  if (capacity == 1 || capacity / 2 < lastIndex + 1)
   {
     return;
   }
 
-  capacity /= 2;
-  T *temp = new T[capacity];
+  reallocate(capacity / 2);
+}
 
-  for (int i = 0; i <= lastIndex; i++)
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::reserve(int size)
+{
+  if (size > capacity)
   {
-    temp[i] = ptr[i];
+    reallocate(size);
   }
+}
 
-  delete[] ptr;
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::shrink_to_fit()
+{
+  int size = lastIndex < 0 ? 1 : lastIndex + 1;
+
+  if (size < capacity)
+  {
+    reallocate(size);
+  }
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::setAutoShrink(bool enable)
+{
+  autoShrink = enable;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::setHugePages(bool enable)
+{
+  if (enable == hugePages)
+  {
+    return;
+  }
+
+  if (ptr == nullptr)
+  {
+    hugePages = enable;
+    return;
+  }
+
+  T *temp = allocate(capacity, enable);
+
+  try
+  {
+    relocateTo(temp);
+  }
+  catch (...)
+  {
+    deallocate(temp, capacity, enable);
+    throw;
+  }
+
+  deallocate(ptr, capacity, hugePages);
   ptr = temp;
+  hugePages = enable;
 }
 
-template <typename T>
-int DynArray<T>::countItems() const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::countItems() const
 {
   return lastIndex + 1;
 }
 
-template <typename T>
-T DynArray<T>::getItem(int index) const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+T DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::getItem(int index) const
 {
-  if (index < 0 || index > lastIndex + 1)
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+const T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::at(int index)
+{
+  if (index < 0 || index > lastIndex)
   {
     throw out_of_range("Index of array is out of range.");
   }
@@ -234,9 +1148,25 @@ T DynArray<T>::getItem(int index) const
   return ptr[index];
 }
 
-template <typename T>
-int DynArray<T>::findIndex(T item) const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+const T &DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::at(int index) const
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  return ptr[index];
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::findIndex(const T &item) const
 {
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::findFirst(ptr, lastIndex + 1, item);
+  }
+
   for (int i = 0; i <= lastIndex; i++)
   {
     if (ptr[i] == item)
@@ -247,8 +1177,129 @@ int DynArray<T>::findIndex(T item) const
   return -1;
 }
 
-template <typename T>
-int DynArray<T>::getCapacity() const
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<int> DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::findAll(const T &item) const
 {
-  return capacity();
-}
\ No newline at end of file
+  DynArray<int> indices;
+
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    simd::forEachMatch(ptr, lastIndex + 1, item, [&indices](int index)
+                       { indices.append(index); });
+    return indices;
+  }
+
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (ptr[i] == item)
+    {
+      indices.append(i);
+    }
+  }
+  return indices;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::count(const T &item) const
+{
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::count(ptr, lastIndex + 1, item);
+  }
+
+  int total = 0;
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (ptr[i] == item)
+    {
+      total++;
+    }
+  }
+  return total;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::containsAny(const T *items, int size) const
+{
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::containsAny(ptr, lastIndex + 1, items, size);
+  }
+
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    for (int j = 0; j < size; j++)
+    {
+      if (ptr[i] == items[j])
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+#if __cplusplus >= 202002L
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::containsAny(std::span<const T> items) const
+{
+  return containsAny(items.data(), static_cast<int>(items.size()));
+}
+#endif
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::getCapacity() const
+{
+  return capacity;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+T *DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::data()
+{
+  return ptr;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+const T *DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::data() const
+{
+  return ptr;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::iterator DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::begin()
+{
+  return ptr;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::iterator DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::end()
+{
+  return ptr + lastIndex + 1;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::const_iterator DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::begin() const
+{
+  return ptr;
+}
+
+template <typename T, typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::const_iterator DynArray<T, GrowthPolicy, CheckPolicy, Alignment>::end() const
+{
+  return ptr + lastIndex + 1;
+}
+
+#if __cplusplus >= 202002L
+static_assert(std::ranges::contiguous_range<DynArray<int>>);
+#endif
+
+// Bit-packed DynArray<bool>
+#include "dynamic_bit_array.cpp"
+
+#endif
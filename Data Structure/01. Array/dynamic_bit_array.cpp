@@ -0,0 +1,603 @@
+#ifndef DYNAMIC_BIT_ARRAY_CPP
+
+#define DYNAMIC_BIT_ARRAY_CPP
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include "dynamic_array.cpp"
+
+// DynArray<bool> packs 64 flags into each word instead of spending a byte on
+// every flag. Counting is a popcount per word, searching skips whole words
+// and finds the bit with a count-trailing-zeros, and and/or/xor between two
+// arrays run a word at a time. Bits past the last flag are always zero, so
+// whole words can be counted and combined without masking.
+//
+// Like std::vector<bool>, operator[] returns a proxy instead of a bool &.
+// Generic code over DynArray<T> does not work with T = bool: there is no
+// data(), begin()/end() or contiguous range over the flags, and no
+// emplace/emplace_back, insertRange, removeRange, removeIf, the sorts,
+// shrink_to_fit, doubleArray/halfArray, setAutoShrink/setHugePages,
+// containsAny or writeTo/readFrom. Use DynArray<unsigned char> for flags
+// that need those.
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+class DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+public:
+  using Word = std::uint64_t;
+  static const int WORD_BITS = 64;
+
+private:
+  static constexpr std::size_t ALIGNMENT = Alignment < alignof(Word) ? alignof(Word) : Alignment;
+
+  // Capacity in words; the array holds up to capacity * 64 flags
+  int capacity;
+  int lastIndex;
+  Word *words;
+
+  // Returns a zero-filled block of the given number of words
+  static Word *allocate(int);
+  static void deallocate(Word *, int);
+
+  static int wordsFor(int);
+  static Word bitOf(int);
+
+  int usedWords() const;
+
+  // Moves the words to a zero-filled block of the given capacity
+  void reallocate(int);
+  void growIfFull();
+
+  // Zeroes the bits past the last flag after an operation that may set them
+  void clearTail();
+
+  // Index of the first bit at or after 'from' whose value is 'value'
+  int scan(int, bool) const;
+
+protected:
+  bool isFull() const;
+  void clear();
+
+public:
+  using value_type = bool;
+
+  // Writable view of one flag
+  class Reference
+  {
+  private:
+    Word *word;
+    Word mask;
+
+  public:
+    Reference(Word *target, Word bit) : word(target), mask(bit) {}
+
+    operator bool() const { return (*word & mask) != 0; }
+
+    Reference &operator=(bool value)
+    {
+      *word = value ? (*word | mask) : (*word & ~mask);
+      return *this;
+    }
+
+    Reference &operator=(const Reference &other)
+    {
+      return *this = static_cast<bool>(other);
+    }
+
+    void flip() { *word ^= mask; }
+  };
+
+  DynArray(int);
+  DynArray();
+  ~DynArray();
+  DynArray(const DynArray &);
+  DynArray(DynArray &&) noexcept;
+  DynArray &operator=(const DynArray &);
+  DynArray &operator=(DynArray &&) noexcept;
+
+  void append(bool);
+  void insert(bool, int);
+  void remove(int);
+  void replace(bool, int);
+
+  // Grows the capacity to at least the given number of flags
+  void reserve(int);
+
+  bool getItem(int) const;
+
+  // Proxy access; operator[] follows CheckPolicy, at() always throws
+  Reference operator[](int);
+  bool operator[](int) const;
+  Reference at(int);
+  bool at(int) const;
+
+  // Index of the first flag equal to the given value, otherwise -1
+  int findIndex(bool) const;
+
+  // Index of the first set flag, or of the next one after the given index,
+  // otherwise -1. Together they walk every set flag:
+  // for (int i = a.findFirst(); i != -1; i = a.findNext(i))
+  int findFirst() const;
+  int findNext(int) const;
+
+  // Number of set flags, or of flags equal to the given value
+  int count() const;
+  int count(bool) const;
+
+  // Word at a time bulk operations; both arrays must hold as many flags
+  DynArray &operator&=(const DynArray &);
+  DynArray &operator|=(const DynArray &);
+  DynArray &operator^=(const DynArray &);
+
+  // Inverts every flag
+  void flip();
+
+  bool isEmpty() const;
+  int countItems() const;
+  int getCapacity() const;
+  void display() const;
+  int size() const;
+
+  // Packed storage: flag i is bit i % 64 of word i / 64
+  const Word *wordData() const;
+  int wordCount() const;
+};
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::Word *DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::allocate(int size)
+{
+  std::size_t bytes = static_cast<std::size_t>(size) * sizeof(Word);
+  Word *block = static_cast<Word *>(memory::allocate(bytes, ALIGNMENT, false));
+  std::memset(block, 0, bytes);
+  return block;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::deallocate(Word *block, int size)
+{
+  memory::deallocate(block, static_cast<std::size_t>(size) * sizeof(Word), ALIGNMENT, false);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::wordsFor(int bits)
+{
+  return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::Word DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::bitOf(int index)
+{
+  return Word(1) << (index % WORD_BITS);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::usedWords() const
+{
+  return wordsFor(lastIndex + 1);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::DynArray(int initialSize)
+{
+  capacity = wordsFor(initialSize < 1 ? 1 : initialSize);
+  lastIndex = -1;
+  words = allocate(capacity);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::DynArray()
+{
+  capacity = 1;
+  lastIndex = -1;
+  words = allocate(capacity);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::~DynArray()
+{
+  clear();
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::DynArray(const DynArray &obj)
+{
+  capacity = obj.capacity;
+  lastIndex = obj.lastIndex;
+  words = allocate(capacity);
+  std::memcpy(words, obj.words, usedWords() * sizeof(Word));
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::DynArray(DynArray &&obj) noexcept
+    : capacity(obj.capacity), lastIndex(obj.lastIndex), words(obj.words)
+{
+  obj.capacity = 0;
+  obj.lastIndex = -1;
+  obj.words = nullptr;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment> &DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator=(const DynArray &obj)
+{
+  if (this != &obj)
+  {
+    Word *temp = allocate(obj.capacity);
+    std::memcpy(temp, obj.words, obj.usedWords() * sizeof(Word));
+
+    clear();
+    capacity = obj.capacity;
+    lastIndex = obj.lastIndex;
+    words = temp;
+  }
+
+  return *this;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment> &DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator=(DynArray &&obj) noexcept
+{
+  if (this != &obj)
+  {
+    clear();
+    capacity = obj.capacity;
+    lastIndex = obj.lastIndex;
+    words = obj.words;
+
+    obj.capacity = 0;
+    obj.lastIndex = -1;
+    obj.words = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::clear()
+{
+  if (words != nullptr)
+  {
+    deallocate(words, capacity);
+    words = nullptr;
+  }
+  capacity = 0;
+  lastIndex = -1;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::reallocate(int newCapacity)
+{
+  Word *temp = allocate(newCapacity);
+
+  if (words != nullptr)
+  {
+    std::memcpy(temp, words, usedWords() * sizeof(Word));
+    deallocate(words, capacity);
+  }
+
+  words = temp;
+  capacity = newCapacity;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::isFull() const
+{
+  return lastIndex + 1 == capacity * WORD_BITS;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::growIfFull()
+{
+  if (isFull())
+  {
+    reallocate(GrowthPolicy::grow(capacity, sizeof(Word)));
+  }
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::clearTail()
+{
+  int used = lastIndex + 1;
+  if (used % WORD_BITS != 0)
+  {
+    words[used / WORD_BITS] &= bitOf(used) - 1;
+  }
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::append(bool item)
+{
+  growIfFull();
+
+  lastIndex++;
+  if (item)
+  {
+    words[lastIndex / WORD_BITS] |= bitOf(lastIndex);
+  }
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::insert(bool item, int index)
+{
+  if (index < 0 || index > lastIndex + 1)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  growIfFull();
+  lastIndex++;
+
+  // Shift the bits from 'index' one step up, carrying the top bit of each
+  // word into the next one
+  int first = index / WORD_BITS;
+  int last = lastIndex / WORD_BITS;
+  for (int i = last; i > first; i--)
+  {
+    words[i] = (words[i] << 1) | (words[i - 1] >> (WORD_BITS - 1));
+  }
+
+  Word low = bitOf(index) - 1;
+  words[first] = (words[first] & low) | ((words[first] & ~low) << 1);
+
+  if (item)
+  {
+    words[first] |= bitOf(index);
+  }
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::remove(int index)
+{
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
+
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  // Shift the bits above 'index' one step down, pulling the lowest bit of
+  // each following word into the top of the previous one
+  int first = index / WORD_BITS;
+  int last = lastIndex / WORD_BITS;
+
+  Word low = bitOf(index) - 1;
+  words[first] = (words[first] & low) | ((words[first] >> 1) & ~low);
+
+  for (int i = first; i < last; i++)
+  {
+    words[i] |= words[i + 1] << (WORD_BITS - 1);
+    words[i + 1] >>= 1;
+  }
+
+  lastIndex--;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::replace(bool item, int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  Reference(words + index / WORD_BITS, bitOf(index)) = item;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::reserve(int size)
+{
+  if (wordsFor(size) > capacity)
+  {
+    reallocate(wordsFor(size));
+  }
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return (words[index / WORD_BITS] & bitOf(index)) != 0;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::Reference DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return Reference(words + index / WORD_BITS, bitOf(index));
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator[](int index) const
+{
+  return getItem(index);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+typename DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::Reference DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::at(int index)
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  return Reference(words + index / WORD_BITS, bitOf(index));
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::at(int index) const
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  return (words[index / WORD_BITS] & bitOf(index)) != 0;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::scan(int from, bool value) const
+{
+  if (from > lastIndex)
+  {
+    return -1;
+  }
+
+  int i = from / WORD_BITS;
+  int last = lastIndex / WORD_BITS;
+
+  // Searching for a clear bit is searching the inverted word for a set one
+  Word invert = value ? 0 : ~Word(0);
+  Word word = (words[i] ^ invert) & ~(bitOf(from) - 1);
+
+  while (word == 0)
+  {
+    if (++i > last)
+    {
+      return -1;
+    }
+    word = words[i] ^ invert;
+  }
+
+  // The inverted tail of the last word is all ones, so check the bound
+  int found = i * WORD_BITS + __builtin_ctzll(word);
+  return found <= lastIndex ? found : -1;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::findIndex(bool item) const
+{
+  return scan(0, item);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::findFirst() const
+{
+  return scan(0, true);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::findNext(int index) const
+{
+  return scan(index < 0 ? 0 : index + 1, true);
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::count() const
+{
+  return simd::popcount(words, usedWords());
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::count(bool item) const
+{
+  return item ? count() : countItems() - count();
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment> &DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator&=(const DynArray &obj)
+{
+  if (obj.lastIndex != lastIndex)
+  {
+    throw std::invalid_argument("Both arrays must hold the same number of flags.");
+  }
+
+  for (int i = 0; i < usedWords(); i++)
+  {
+    words[i] &= obj.words[i];
+  }
+  return *this;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment> &DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator|=(const DynArray &obj)
+{
+  if (obj.lastIndex != lastIndex)
+  {
+    throw std::invalid_argument("Both arrays must hold the same number of flags.");
+  }
+
+  for (int i = 0; i < usedWords(); i++)
+  {
+    words[i] |= obj.words[i];
+  }
+  return *this;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+DynArray<bool, GrowthPolicy, CheckPolicy, Alignment> &DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::operator^=(const DynArray &obj)
+{
+  if (obj.lastIndex != lastIndex)
+  {
+    throw std::invalid_argument("Both arrays must hold the same number of flags.");
+  }
+
+  for (int i = 0; i < usedWords(); i++)
+  {
+    words[i] ^= obj.words[i];
+  }
+  return *this;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::flip()
+{
+  for (int i = 0; i < usedWords(); i++)
+  {
+    words[i] = ~words[i];
+  }
+  clearTail();
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+bool DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::isEmpty() const
+{
+  return lastIndex == -1;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::countItems() const
+{
+  return lastIndex + 1;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::getCapacity() const
+{
+  return capacity * WORD_BITS;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+void DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::display() const
+{
+  std::cout << "[";
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    std::cout << getItem(i) << (i == lastIndex ? "" : ", ");
+  }
+  std::cout << "]";
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+const typename DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::Word *DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::wordData() const
+{
+  return words;
+}
+
+template <typename GrowthPolicy, typename CheckPolicy, std::size_t Alignment>
+int DynArray<bool, GrowthPolicy, CheckPolicy, Alignment>::wordCount() const
+{
+  return usedWords();
+}
+
+#endif
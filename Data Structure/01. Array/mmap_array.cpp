@@ -0,0 +1,462 @@
+#ifndef MMAP_ARRAY_CPP
+
+#define MMAP_ARRAY_CPP
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "custom_exception"
+#include "check_policy.hpp"
+#include "simd_kernels.hpp"
+#include "array_io.hpp"
+
+// Access pattern hints forwarded to madvise()
+enum class MmapAdvice
+{
+  Normal,
+  Sequential,
+  Random,
+  WillNeed
+};
+
+// Persistent DynArray whose storage is a memory-mapped file (POSIX only).
+// The file holds a small header followed by the raw items, so reopening it
+// after a restart maps the data back in without parsing anything. Growing
+// extends the file and remaps it. Only trivially copyable items can be
+// stored this way.
+template <typename T, typename CheckPolicy = Checked>
+class MmapArray
+{
+  static_assert(std::is_trivially_copyable<T>::value, "MmapArray only stores trivially copyable items.");
+
+private:
+  // Same layout as the dumps of DynArray::writeTo (see array_io.hpp)
+  typedef io::FileHeader Header;
+
+  static const std::size_t DATA_OFFSET = io::DATA_OFFSET;
+  static const std::uint32_t VERSION = io::VERSION;
+
+  int fd;
+  int capacity;
+  std::size_t mappedBytes;
+  void *mapping;
+
+  Header *header() const;
+  T *items() const;
+
+  static std::size_t fileBytes(int);
+  static void fail(const char *);
+
+  // Resizes the file to hold 'size' items and maps it again
+  void remap(int);
+  void close();
+
+public:
+  // Opens the file at the given path, creating it with room for the given
+  // number of items if it does not exist yet
+  explicit MmapArray(const std::string &, int = 1024);
+  ~MmapArray();
+  MmapArray(const MmapArray &) = delete;
+  MmapArray &operator=(const MmapArray &) = delete;
+  MmapArray(MmapArray &&) noexcept;
+  MmapArray &operator=(MmapArray &&) noexcept;
+
+  void append(const T &);
+  void replace(const T &, int);
+  void reserve(int);
+
+  T getItem(int) const;
+  T &operator[](int);
+  const T &operator[](int) const;
+  int findIndex(const T &) const;
+
+  bool isEmpty() const;
+  int countItems() const;
+  int getCapacity() const;
+
+  // Writes the dirty pages back to the file and waits for it
+  void flush();
+
+  // Tells the kernel how the items are going to be accessed
+  void advise(MmapAdvice);
+
+  T *data();
+  const T *data() const;
+  int size() const;
+  T *begin();
+  T *end();
+  const T *begin() const;
+  const T *end() const;
+};
+
+template <typename T, typename CheckPolicy>
+typename MmapArray<T, CheckPolicy>::Header *MmapArray<T, CheckPolicy>::header() const
+{
+  return static_cast<Header *>(mapping);
+}
+
+template <typename T, typename CheckPolicy>
+T *MmapArray<T, CheckPolicy>::items() const
+{
+  if (mapping == nullptr)
+  {
+    return nullptr;
+  }
+
+  return reinterpret_cast<T *>(static_cast<char *>(mapping) + DATA_OFFSET);
+}
+
+template <typename T, typename CheckPolicy>
+std::size_t MmapArray<T, CheckPolicy>::fileBytes(int size)
+{
+  return DATA_OFFSET + static_cast<std::size_t>(size) * sizeof(T);
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::fail(const char *msg)
+{
+  throw std::system_error(errno, std::generic_category(), msg);
+}
+
+template <typename T, typename CheckPolicy>
+MmapArray<T, CheckPolicy>::MmapArray(const std::string &path, int initialSize)
+    : fd(-1), capacity(0), mappedBytes(0), mapping(nullptr)
+{
+  static_assert(alignof(T) <= DATA_OFFSET, "Items need a stricter alignment than the data offset.");
+
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd == -1)
+  {
+    fail("Cannot open the array file");
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == -1)
+  {
+    ::close(fd);
+    fail("Cannot read the size of the array file");
+  }
+
+  bool isNew = info.st_size == 0;
+  std::size_t bytes = isNew ? fileBytes(initialSize < 1 ? 1 : initialSize) : static_cast<std::size_t>(info.st_size);
+
+  if (!isNew && bytes < DATA_OFFSET)
+  {
+    ::close(fd);
+    throw std::runtime_error("File is too small to be an array file.");
+  }
+
+  if (isNew && ftruncate(fd, bytes) == -1)
+  {
+    ::close(fd);
+    fail("Cannot size the array file");
+  }
+
+  mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED)
+  {
+    mapping = nullptr;
+    ::close(fd);
+    fail("Cannot map the array file");
+  }
+
+  mappedBytes = bytes;
+
+  // A capacity that does not fit an int would wrap around
+  if ((bytes - DATA_OFFSET) / sizeof(T) > static_cast<std::size_t>(INT_MAX))
+  {
+    close();
+    throw std::length_error("Array file holds more than INT_MAX items.");
+  }
+
+  capacity = static_cast<int>((bytes - DATA_OFFSET) / sizeof(T));
+
+  if (isNew)
+  {
+    std::memcpy(header()->magic, io::MAGIC, sizeof(io::MAGIC));
+    header()->version = VERSION;
+    header()->itemSize = sizeof(T);
+    header()->count = 0;
+    return;
+  }
+
+  // A reopened file must have been written for the same item type
+  if (std::memcmp(header()->magic, io::MAGIC, sizeof(io::MAGIC)) != 0 || header()->version != VERSION ||
+      header()->itemSize != sizeof(T) || header()->count > static_cast<std::uint64_t>(capacity))
+  {
+    close();
+    throw std::runtime_error("File is not an array file of this item type.");
+  }
+}
+
+template <typename T, typename CheckPolicy>
+MmapArray<T, CheckPolicy>::~MmapArray()
+{
+  close();
+}
+
+template <typename T, typename CheckPolicy>
+MmapArray<T, CheckPolicy>::MmapArray(MmapArray &&obj) noexcept
+    : fd(obj.fd), capacity(obj.capacity), mappedBytes(obj.mappedBytes), mapping(obj.mapping)
+{
+  obj.fd = -1;
+  obj.capacity = 0;
+  obj.mappedBytes = 0;
+  obj.mapping = nullptr;
+}
+
+template <typename T, typename CheckPolicy>
+MmapArray<T, CheckPolicy> &MmapArray<T, CheckPolicy>::operator=(MmapArray &&obj) noexcept
+{
+  if (this != &obj)
+  {
+    close();
+    fd = obj.fd;
+    capacity = obj.capacity;
+    mappedBytes = obj.mappedBytes;
+    mapping = obj.mapping;
+
+    obj.fd = -1;
+    obj.capacity = 0;
+    obj.mappedBytes = 0;
+    obj.mapping = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::close()
+{
+  if (mapping != nullptr)
+  {
+    munmap(mapping, mappedBytes);
+    mapping = nullptr;
+  }
+
+  if (fd != -1)
+  {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::remap(int size)
+{
+  std::size_t bytes = fileBytes(size);
+
+  if (ftruncate(fd, bytes) == -1)
+  {
+    fail("Cannot grow the array file");
+  }
+
+#ifdef __linux__
+  void *block = mremap(mapping, mappedBytes, bytes, MREMAP_MAYMOVE);
+#else
+  void *block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (block != MAP_FAILED)
+  {
+    munmap(mapping, mappedBytes);
+  }
+#endif
+
+  if (block == MAP_FAILED)
+  {
+    fail("Cannot map the grown array file");
+  }
+
+  mapping = block;
+  mappedBytes = bytes;
+  capacity = size;
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::append(const T &item)
+{
+  int count = countItems();
+
+  if (count == capacity)
+  {
+    if (capacity == INT_MAX)
+    {
+      throw std::length_error("Array cannot hold more than INT_MAX items.");
+    }
+
+    // Copy first, the item may live in the mapping that is about to move
+    T copy = item;
+    remap(capacity < 1 ? 1 : capacity > INT_MAX / 2 ? INT_MAX : capacity * 2);
+    items()[count] = copy;
+  }
+  else
+  {
+    items()[count] = item;
+  }
+
+  header()->count = count + 1;
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::replace(const T &item, int index)
+{
+  CheckPolicy::check(index >= 0 && index < countItems(), "Index of array is out of range.");
+
+  items()[index] = item;
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::reserve(int size)
+{
+  if (size > capacity)
+  {
+    remap(size);
+  }
+}
+
+template <typename T, typename CheckPolicy>
+T MmapArray<T, CheckPolicy>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index < countItems(), "Index of array is out of range.");
+
+  return items()[index];
+}
+
+template <typename T, typename CheckPolicy>
+T &MmapArray<T, CheckPolicy>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index < countItems(), "Index of array is out of range.");
+
+  return items()[index];
+}
+
+template <typename T, typename CheckPolicy>
+const T &MmapArray<T, CheckPolicy>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index < countItems(), "Index of array is out of range.");
+
+  return items()[index];
+}
+
+template <typename T, typename CheckPolicy>
+int MmapArray<T, CheckPolicy>::findIndex(const T &item) const
+{
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    return simd::findFirst(items(), countItems(), item);
+  }
+
+  for (int i = 0; i < countItems(); i++)
+  {
+    if (items()[i] == item)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename T, typename CheckPolicy>
+bool MmapArray<T, CheckPolicy>::isEmpty() const
+{
+  return countItems() == 0;
+}
+
+template <typename T, typename CheckPolicy>
+int MmapArray<T, CheckPolicy>::countItems() const
+{
+  return mapping == nullptr ? 0 : static_cast<int>(header()->count);
+}
+
+template <typename T, typename CheckPolicy>
+int MmapArray<T, CheckPolicy>::getCapacity() const
+{
+  return capacity;
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::flush()
+{
+  if (mapping != nullptr && msync(mapping, mappedBytes, MS_SYNC) == -1)
+  {
+    fail("Cannot flush the array file");
+  }
+}
+
+template <typename T, typename CheckPolicy>
+void MmapArray<T, CheckPolicy>::advise(MmapAdvice advice)
+{
+  int flag = MADV_NORMAL;
+
+  switch (advice)
+  {
+  case MmapAdvice::Sequential:
+    flag = MADV_SEQUENTIAL;
+    break;
+  case MmapAdvice::Random:
+    flag = MADV_RANDOM;
+    break;
+  case MmapAdvice::WillNeed:
+    flag = MADV_WILLNEED;
+    break;
+  default:
+    break;
+  }
+
+  if (mapping != nullptr && madvise(mapping, mappedBytes, flag) == -1)
+  {
+    fail("Cannot apply the access advice");
+  }
+}
+
+template <typename T, typename CheckPolicy>
+T *MmapArray<T, CheckPolicy>::data()
+{
+  return items();
+}
+
+template <typename T, typename CheckPolicy>
+const T *MmapArray<T, CheckPolicy>::data() const
+{
+  return items();
+}
+
+template <typename T, typename CheckPolicy>
+int MmapArray<T, CheckPolicy>::size() const
+{
+  return countItems();
+}
+
+template <typename T, typename CheckPolicy>
+T *MmapArray<T, CheckPolicy>::begin()
+{
+  return items();
+}
+
+template <typename T, typename CheckPolicy>
+T *MmapArray<T, CheckPolicy>::end()
+{
+  return items() + countItems();
+}
+
+template <typename T, typename CheckPolicy>
+const T *MmapArray<T, CheckPolicy>::begin() const
+{
+  return items();
+}
+
+template <typename T, typename CheckPolicy>
+const T *MmapArray<T, CheckPolicy>::end() const
+{
+  return items() + countItems();
+}
+
+#endif
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include "aligned_memory.hpp"
+
+#ifndef PARALLEL_SORT_HPP
+
+#define PARALLEL_SORT_HPP
+
+// Multithreaded sorting of a contiguous range on plain std::thread, used by
+// DynArray::sort, stableSort and partialSort.
+//
+// The range is cut into one block per thread and every block is sorted with
+// std::sort (introsort) or std::stable_sort. Regular samples of the sorted
+// blocks give one pivot per thread boundary, the pivots split every block
+// into buckets with a binary search, and each thread then merges one bucket
+// from all blocks with a k-way merge into a scratch buffer. Buckets are
+// disjoint ranges of the output, so the merge needs no locking either.
+//
+// The comparator is called from several threads at once, so it must not
+// modify shared state. If it throws, the exception reaches the caller after
+// all threads stop, and the items are left in unspecified order.
+namespace parallel
+{
+  // Below this many items per thread, starting threads costs more than it saves
+  const int MIN_ITEMS_PER_THREAD = 1 << 15;
+
+  inline int threadCount(int requested, int n)
+  {
+    int threads = requested > 0 ? requested : static_cast<int>(std::thread::hardware_concurrency());
+    int useful = n / MIN_ITEMS_PER_THREAD;
+
+    if (threads > useful)
+    {
+      threads = useful;
+    }
+    return threads < 1 ? 1 : threads;
+  }
+
+  // Runs task(0) .. task(count - 1) in parallel, task 0 on the calling thread,
+  // and rethrows the first exception once every task has finished
+  template <typename Task>
+  void runTasks(int count, Task &task)
+  {
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[count]);
+    std::unique_ptr<std::thread[]> workers(new std::thread[count]);
+
+    auto guarded = [&task, &errors](int i)
+    {
+      try
+      {
+        task(i);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    };
+
+    for (int i = 1; i < count; i++)
+    {
+      try
+      {
+        workers[i] = std::thread(guarded, i);
+      }
+      catch (...)
+      {
+        // Out of threads: do the work here instead
+        guarded(i);
+      }
+    }
+
+    guarded(0);
+
+    for (int i = 1; i < count; i++)
+    {
+      if (workers[i].joinable())
+      {
+        workers[i].join();
+      }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+      if (errors[i])
+      {
+        std::rethrow_exception(errors[i]);
+      }
+    }
+  }
+
+  template <typename T, typename Compare>
+  void sortRange(T *data, int n, Compare comp, int requested, bool stable)
+  {
+    int threads = threadCount(requested, n);
+
+    if (threads == 1)
+    {
+      if (stable)
+      {
+        std::stable_sort(data, data + n, comp);
+      }
+      else
+      {
+        std::sort(data, data + n, comp);
+      }
+      return;
+    }
+
+    auto blockBegin = [n, threads](int block)
+    {
+      return static_cast<int>(static_cast<long long>(n) * block / threads);
+    };
+
+    // 1. Sort every block on its own
+    auto sortBlock = [&](int block)
+    {
+      if (stable)
+      {
+        std::stable_sort(data + blockBegin(block), data + blockBegin(block + 1), comp);
+      }
+      else
+      {
+        std::sort(data + blockBegin(block), data + blockBegin(block + 1), comp);
+      }
+    };
+    runTasks(threads, sortBlock);
+
+    // 2. 'threads' evenly spaced samples from each sorted block; every
+    // threads-th sample of the sorted samples becomes a pivot. Pointers are
+    // kept so that T needs no default constructor.
+    int sampleCount = threads * threads;
+    std::unique_ptr<const T *[]> samples(new const T *[sampleCount]);
+
+    for (int block = 0; block < threads; block++)
+    {
+      int begin = blockBegin(block);
+      int length = blockBegin(block + 1) - begin;
+
+      for (int k = 0; k < threads; k++)
+      {
+        samples[block * threads + k] = data + begin + static_cast<int>(static_cast<long long>(length) * k / threads);
+      }
+    }
+
+    std::sort(samples.get(), samples.get() + sampleCount, [&comp](const T *a, const T *b)
+              { return comp(*a, *b); });
+
+    std::unique_ptr<const T *[]> pivots(new const T *[threads - 1]);
+    for (int j = 1; j < threads; j++)
+    {
+      pivots[j - 1] = samples[j * threads + threads / 2 - 1];
+    }
+
+    // 3. Bucket j of block i is [cuts[i][j], cuts[i][j + 1]). upper_bound puts
+    // every item equal to a pivot in the same bucket, which keeps the merge
+    // stable.
+    int stride = threads + 1;
+    std::unique_ptr<int[]> cuts(new int[threads * stride]);
+
+    auto cutBlock = [&](int block)
+    {
+      int *row = cuts.get() + block * stride;
+      row[0] = blockBegin(block);
+      row[threads] = blockBegin(block + 1);
+
+      for (int j = 1; j < threads; j++)
+      {
+        row[j] = static_cast<int>(std::upper_bound(data + row[j - 1], data + row[threads], *pivots[j - 1], comp) - data);
+      }
+    };
+    runTasks(threads, cutBlock);
+
+    std::unique_ptr<int[]> offsets(new int[threads + 1]);
+    offsets[0] = 0;
+    for (int j = 0; j < threads; j++)
+    {
+      int size = 0;
+      for (int block = 0; block < threads; block++)
+      {
+        size += cuts[block * stride + j + 1] - cuts[block * stride + j];
+      }
+      offsets[j + 1] = offsets[j] + size;
+    }
+
+    // 4. Merge bucket j of every block into its slice of the buffer
+    std::size_t bytes = static_cast<std::size_t>(n) * sizeof(T);
+    T *buffer = static_cast<T *>(memory::allocate(bytes, alignof(T), false));
+    std::unique_ptr<int[]> built(new int[threads]());
+
+    auto mergeBucket = [&](int bucket)
+    {
+      std::unique_ptr<T *[]> cursor(new T *[threads]);
+      std::unique_ptr<T *[]> end(new T *[threads]);
+      std::unique_ptr<int[]> heap(new int[threads]);
+      int heapSize = 0;
+
+      for (int block = 0; block < threads; block++)
+      {
+        cursor[block] = data + cuts[block * stride + bucket];
+        end[block] = data + cuts[block * stride + bucket + 1];
+        if (cursor[block] != end[block])
+        {
+          heap[heapSize++] = block;
+        }
+      }
+
+      // Min-heap on the current items; ties go to the lower block
+      auto later = [&](int a, int b)
+      {
+        return comp(*cursor[b], *cursor[a]) || (!comp(*cursor[a], *cursor[b]) && b < a);
+      };
+      std::make_heap(heap.get(), heap.get() + heapSize, later);
+
+      T *out = buffer + offsets[bucket];
+      int &count = built[bucket];
+
+      try
+      {
+        while (heapSize > 0)
+        {
+          std::pop_heap(heap.get(), heap.get() + heapSize, later);
+          int block = heap[heapSize - 1];
+
+          ::new (static_cast<void *>(out + count)) T(std::move(*cursor[block]));
+          count++;
+
+          if (++cursor[block] == end[block])
+          {
+            heapSize--;
+          }
+          else
+          {
+            std::push_heap(heap.get(), heap.get() + heapSize, later);
+          }
+        }
+      }
+      catch (...)
+      {
+        std::destroy_n(out, count);
+        count = 0;
+        throw;
+      }
+    };
+
+    // 5. Move every bucket back in place and end the buffer's items
+    auto copyBack = [&](int bucket)
+    {
+      T *from = buffer + offsets[bucket];
+      int count = offsets[bucket + 1] - offsets[bucket];
+
+      try
+      {
+        std::move(from, from + count, data + offsets[bucket]);
+      }
+      catch (...)
+      {
+        std::destroy_n(from, count);
+        throw;
+      }
+      std::destroy_n(from, count);
+    };
+
+    try
+    {
+      runTasks(threads, mergeBucket);
+    }
+    catch (...)
+    {
+      for (int bucket = 0; bucket < threads; bucket++)
+      {
+        std::destroy_n(buffer + offsets[bucket], built[bucket]);
+      }
+      memory::deallocate(buffer, bytes, alignof(T), false);
+      throw;
+    }
+
+    try
+    {
+      runTasks(threads, copyBack);
+    }
+    catch (...)
+    {
+      memory::deallocate(buffer, bytes, alignof(T), false);
+      throw;
+    }
+    memory::deallocate(buffer, bytes, alignof(T), false);
+  }
+
+  template <typename T, typename Compare>
+  void sort(T *data, int n, Compare comp, int threads = 0)
+  {
+    sortRange(data, n, comp, threads, false);
+  }
+
+  template <typename T, typename Compare>
+  void stableSort(T *data, int n, Compare comp, int threads = 0)
+  {
+    sortRange(data, n, comp, threads, true);
+  }
+
+  // Puts the 'count' smallest items in order at the front; the rest follow
+  // in unspecified order
+  template <typename T, typename Compare>
+  void partialSort(T *data, int n, int count, Compare comp, int threads = 0)
+  {
+    if (count <= 0)
+    {
+      return;
+    }
+
+    if (count < n)
+    {
+      std::nth_element(data, data + count, data + n, comp);
+    }
+    else
+    {
+      count = n;
+    }
+
+    sortRange(data, count, comp, threads, false);
+  }
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "aligned_memory.hpp"
+
+#ifndef RADIX_SORT_HPP
+
+#define RADIX_SORT_HPP
+
+// LSD radix sort for integer and floating point keys, behind
+// DynArray::radixSort for plain numbers and DynArray::sortByKey for records.
+//
+// Keys are mapped to unsigned integers that order the same way (the sign bit
+// of signed integers is flipped, negative floats are inverted) and sorted one
+// digit at a time, least significant first, moving the items between the
+// array and one scratch buffer. The histograms of all passes are counted in a
+// single sweep before the first pass, and a pass whose digit is the same for
+// every key is skipped. The sort is stable.
+namespace radix
+{
+  template <typename T>
+  struct IsSortable
+      : std::integral_constant<bool, (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+                                         std::is_same<T, float>::value || std::is_same<T, double>::value>
+  {
+  };
+
+  // Unsigned integer with the size of T
+  template <typename T>
+  using KeyBits = typename std::conditional<
+      sizeof(T) == 1, std::uint8_t,
+      typename std::conditional<sizeof(T) == 2, std::uint16_t,
+                                typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type>::type>::type;
+
+  // Bits of the value, rearranged so that unsigned comparison of the bits
+  // gives the order of the values. -0.0 and 0.0 compare equal, as they do
+  // with <, and NaNs go to the ends according to their sign.
+  template <typename T>
+  inline KeyBits<T> orderedBits(T value)
+  {
+    typedef KeyBits<T> K;
+    const K SIGN = static_cast<K>(K(1) << (sizeof(T) * 8 - 1));
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+      // Turns -0.0 into 0.0, so a stable sort keeps their order
+      if (value == 0)
+      {
+        value = 0;
+      }
+    }
+
+    K bits;
+    std::memcpy(&bits, &value, sizeof(T));
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+      return (bits & SIGN) ? static_cast<K>(~bits) : static_cast<K>(bits | SIGN);
+    }
+    else if constexpr (std::is_signed<T>::value)
+    {
+      return static_cast<K>(bits ^ SIGN);
+    }
+    else
+    {
+      return bits;
+    }
+  }
+
+  // Sorts with 'Bits' wide digits; keyOf returns the unsigned key of an item
+  template <int Bits, typename T, typename KeyOf>
+  void sortDigits(T *data, T *scratch, int n, KeyOf keyOf)
+  {
+    typedef decltype(keyOf(*data)) K;
+    const int RADIX = 1 << Bits;
+    const int PASSES = static_cast<int>((sizeof(K) * 8 + Bits - 1) / Bits);
+    const K MASK = static_cast<K>(RADIX - 1);
+
+    // One sweep over the keys fills the histogram of every pass
+    std::unique_ptr<int[]> counts(new int[PASSES * RADIX]());
+    for (int i = 0; i < n; i++)
+    {
+      K key = keyOf(data[i]);
+      for (int pass = 0; pass < PASSES; pass++)
+      {
+        counts[pass * RADIX + ((key >> (pass * Bits)) & MASK)]++;
+      }
+    }
+
+    K firstKey = keyOf(data[0]);
+    T *from = data;
+    T *to = scratch;
+
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+      int shift = pass * Bits;
+      int *offsets = counts.get() + pass * RADIX;
+
+      // Every key has the same digit here, so the pass would not move anything
+      if (offsets[(firstKey >> shift) & MASK] == n)
+      {
+        continue;
+      }
+
+      int total = 0;
+      for (int digit = 0; digit < RADIX; digit++)
+      {
+        int count = offsets[digit];
+        offsets[digit] = total;
+        total += count;
+      }
+
+      for (int i = 0; i < n; i++)
+      {
+        to[offsets[(keyOf(from[i]) >> shift) & MASK]++] = from[i];
+      }
+
+      std::swap(from, to);
+    }
+
+    if (from != data)
+    {
+      std::memcpy(static_cast<void *>(data), static_cast<const void *>(from), static_cast<std::size_t>(n) * sizeof(T));
+    }
+  }
+
+  // Picks the digit width: narrow digits keep the histograms cheap for small
+  // arrays, wide ones save passes over big arrays while a 16 bit histogram
+  // still fits in the L2 cache
+  template <typename T, typename KeyOf>
+  void sortKeys(T *data, int n, KeyOf keyOf)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Radix sort moves items with plain copies.");
+
+    if (n < 2)
+    {
+      return;
+    }
+
+    std::size_t bytes = static_cast<std::size_t>(n) * sizeof(T);
+    T *scratch = static_cast<T *>(memory::allocate(bytes, alignof(T), false));
+
+    try
+    {
+      typedef decltype(keyOf(*data)) K;
+
+      if (sizeof(K) == 1 || n < (1 << 16))
+      {
+        sortDigits<8>(data, scratch, n, keyOf);
+      }
+      else if (n < (1 << 23))
+      {
+        sortDigits<11>(data, scratch, n, keyOf);
+      }
+      else
+      {
+        sortDigits<16>(data, scratch, n, keyOf);
+      }
+    }
+    catch (...)
+    {
+      memory::deallocate(scratch, bytes, alignof(T), false);
+      throw;
+    }
+
+    memory::deallocate(scratch, bytes, alignof(T), false);
+  }
+
+  // Sorts plain numbers in ascending order
+  template <typename T>
+  void sort(T *data, int n)
+  {
+    static_assert(IsSortable<T>::value, "Radix sort needs integer or floating point items.");
+
+    sortKeys(data, n, [](const T &item)
+             { return orderedBits(item); });
+  }
+
+  // Sorts records by the number key(item) returns, keeping the order of
+  // records with equal keys
+  template <typename T, typename KeyFn>
+  void sortByKey(T *data, int n, KeyFn key)
+  {
+    typedef typename std::decay<decltype(key(*data))>::type Key;
+    static_assert(IsSortable<Key>::value, "Radix sort needs an integer or floating point key.");
+
+    sortKeys(data, n, [&key](const T &item)
+             { return orderedBits(static_cast<Key>(key(item))); });
+  }
+}
+
+#endif
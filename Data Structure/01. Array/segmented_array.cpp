@@ -0,0 +1,473 @@
+#ifndef SEGMENTED_ARRAY_CPP
+
+#define SEGMENTED_ARRAY_CPP
+
+#include <climits>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "custom_exception"
+#include "check_policy.hpp"
+#include "simd_kernels.hpp"
+#include "aligned_memory.hpp"
+
+// Append-only array stored in a fixed directory of blocks whose sizes double
+// (16, 32, 64, ...). Growing allocates the next block and never moves an
+// item, so pointers and references to items stay valid for the lifetime of
+// the array. Block k holds the items [16 * (2^k - 1), 16 * (2^(k+1) - 1)),
+// so the block of an index is found from the highest set bit of index + 16.
+template <typename T, typename CheckPolicy = Checked>
+class SegmentedArray
+{
+private:
+  static const int FIRST_BLOCK_BITS = 4;
+  static const int FIRST_BLOCK = 1 << FIRST_BLOCK_BITS;
+
+  // Enough blocks for any non-negative int index
+  static const int MAX_BLOCKS = 32 - FIRST_BLOCK_BITS;
+
+  T *blocks[MAX_BLOCKS];
+  int blockCount;
+  int lastIndex;
+
+  static std::size_t blockSize(int);
+  static int blockOf(int);
+  static int offsetOf(int, int);
+
+  T *slot(int) const;
+
+  // Makes sure the block for the next item exists
+  void growIfFull();
+
+  template <bool IsConst>
+  class Iterator;
+
+public:
+  using value_type = T;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  SegmentedArray();
+  ~SegmentedArray();
+  SegmentedArray(const SegmentedArray &);
+  SegmentedArray(SegmentedArray &&) noexcept;
+  SegmentedArray &operator=(const SegmentedArray &);
+  SegmentedArray &operator=(SegmentedArray &&) noexcept;
+
+  void append(const T &);
+  void append(T &&);
+
+  template <typename... Args>
+  T &emplace_back(Args &&...);
+
+  // Destroys the last item; the others keep their addresses
+  void removeLast();
+  void replace(const T &, int);
+
+  // Destroys every item and frees the blocks
+  void clear();
+
+  T getItem(int) const;
+
+  // Reference access; operator[] follows CheckPolicy, at() always throws
+  T &operator[](int);
+  const T &operator[](int) const;
+  T &at(int);
+  const T &at(int) const;
+
+  int findIndex(const T &) const;
+  bool isEmpty() const;
+  int countItems() const;
+  int getCapacity() const;
+  void display() const;
+
+  int size() const;
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+};
+
+// Random access iterator over the items. It walks by index, so it stays valid
+// across appends as long as it does not point past the new end.
+template <typename T, typename CheckPolicy>
+template <bool IsConst>
+class SegmentedArray<T, CheckPolicy>::Iterator
+{
+private:
+  using Owner = typename std::conditional<IsConst, const SegmentedArray, SegmentedArray>::type;
+
+  Owner *owner;
+  int index;
+
+  friend class SegmentedArray;
+  friend class Iterator<!IsConst>;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = typename std::conditional<IsConst, const T *, T *>::type;
+  using reference = typename std::conditional<IsConst, const T &, T &>::type;
+
+  Iterator() : owner(nullptr), index(0) {}
+  Iterator(Owner *array, int position) : owner(array), index(position) {}
+
+  // A mutable iterator converts to a const one
+  template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+  Iterator(const Iterator<WasConst> &other) : owner(other.owner), index(other.index) {}
+
+  reference operator*() const { return *owner->slot(index); }
+  pointer operator->() const { return owner->slot(index); }
+  reference operator[](difference_type n) const { return *owner->slot(index + static_cast<int>(n)); }
+
+  Iterator &operator++() { index++; return *this; }
+  Iterator operator++(int) { Iterator old = *this; index++; return old; }
+  Iterator &operator--() { index--; return *this; }
+  Iterator operator--(int) { Iterator old = *this; index--; return old; }
+  Iterator &operator+=(difference_type n) { index += static_cast<int>(n); return *this; }
+  Iterator &operator-=(difference_type n) { index -= static_cast<int>(n); return *this; }
+
+  friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+  friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+  friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+  friend difference_type operator-(const Iterator &a, const Iterator &b) { return a.index - b.index; }
+
+  friend bool operator==(const Iterator &a, const Iterator &b) { return a.index == b.index; }
+  friend bool operator!=(const Iterator &a, const Iterator &b) { return a.index != b.index; }
+  friend bool operator<(const Iterator &a, const Iterator &b) { return a.index < b.index; }
+  friend bool operator>(const Iterator &a, const Iterator &b) { return a.index > b.index; }
+  friend bool operator<=(const Iterator &a, const Iterator &b) { return a.index <= b.index; }
+  friend bool operator>=(const Iterator &a, const Iterator &b) { return a.index >= b.index; }
+};
+
+template <typename T, typename CheckPolicy>
+std::size_t SegmentedArray<T, CheckPolicy>::blockSize(int block)
+{
+  return static_cast<std::size_t>(FIRST_BLOCK) << block;
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::blockOf(int index)
+{
+  unsigned int shifted = static_cast<unsigned int>(index) + FIRST_BLOCK;
+  return 31 - __builtin_clz(shifted) - FIRST_BLOCK_BITS;
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::offsetOf(int index, int block)
+{
+  return static_cast<int>(static_cast<unsigned int>(index) + FIRST_BLOCK - (static_cast<unsigned int>(FIRST_BLOCK) << block));
+}
+
+template <typename T, typename CheckPolicy>
+T *SegmentedArray<T, CheckPolicy>::slot(int index) const
+{
+  int block = blockOf(index);
+  return blocks[block] + offsetOf(index, block);
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy>::SegmentedArray() : blockCount(0), lastIndex(-1)
+{
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy>::~SegmentedArray()
+{
+  clear();
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy>::SegmentedArray(const SegmentedArray &obj) : blockCount(0), lastIndex(-1)
+{
+  try
+  {
+    for (int i = 0; i <= obj.lastIndex; i++)
+    {
+      emplace_back(*obj.slot(i));
+    }
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy>::SegmentedArray(SegmentedArray &&obj) noexcept
+    : blockCount(obj.blockCount), lastIndex(obj.lastIndex)
+{
+  // The blocks change hands, so the items keep their addresses
+  for (int i = 0; i < blockCount; i++)
+  {
+    blocks[i] = obj.blocks[i];
+  }
+
+  obj.blockCount = 0;
+  obj.lastIndex = -1;
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy> &SegmentedArray<T, CheckPolicy>::operator=(const SegmentedArray &obj)
+{
+  if (this != &obj)
+  {
+    SegmentedArray copy(obj);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+template <typename T, typename CheckPolicy>
+SegmentedArray<T, CheckPolicy> &SegmentedArray<T, CheckPolicy>::operator=(SegmentedArray &&obj) noexcept
+{
+  if (this != &obj)
+  {
+    clear();
+
+    blockCount = obj.blockCount;
+    lastIndex = obj.lastIndex;
+    for (int i = 0; i < blockCount; i++)
+    {
+      blocks[i] = obj.blocks[i];
+    }
+
+    obj.blockCount = 0;
+    obj.lastIndex = -1;
+  }
+
+  return *this;
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::clear()
+{
+  for (int i = lastIndex; i >= 0; i--)
+  {
+    slot(i)->~T();
+  }
+
+  for (int i = 0; i < blockCount; i++)
+  {
+    memory::deallocate(blocks[i], blockSize(i) * sizeof(T), alignof(T), false);
+  }
+
+  blockCount = 0;
+  lastIndex = -1;
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::growIfFull()
+{
+  if (lastIndex + 1 < getCapacity())
+  {
+    return;
+  }
+
+  if (blockCount == MAX_BLOCKS)
+  {
+    throw ArrayOverflow("Cannot append an item because array is full!.");
+  }
+
+  blocks[blockCount] = static_cast<T *>(memory::allocate(blockSize(blockCount) * sizeof(T), alignof(T), false));
+  blockCount++;
+}
+
+template <typename T, typename CheckPolicy>
+template <typename... Args>
+T &SegmentedArray<T, CheckPolicy>::emplace_back(Args &&...args)
+{
+  // Nothing moves on growth, so the arguments may refer to items of this array
+  growIfFull();
+
+  T *item = slot(lastIndex + 1);
+  ::new (static_cast<void *>(item)) T(std::forward<Args>(args)...);
+  lastIndex++;
+  return *item;
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::append(const T &item)
+{
+  emplace_back(item);
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::append(T &&item)
+{
+  emplace_back(std::move(item));
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::removeLast()
+{
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
+
+  slot(lastIndex)->~T();
+  lastIndex--;
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::replace(const T &item, int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  *slot(index) = item;
+}
+
+template <typename T, typename CheckPolicy>
+T SegmentedArray<T, CheckPolicy>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return *slot(index);
+}
+
+template <typename T, typename CheckPolicy>
+T &SegmentedArray<T, CheckPolicy>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return *slot(index);
+}
+
+template <typename T, typename CheckPolicy>
+const T &SegmentedArray<T, CheckPolicy>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return *slot(index);
+}
+
+template <typename T, typename CheckPolicy>
+T &SegmentedArray<T, CheckPolicy>::at(int index)
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw std::out_of_range("Index of array is out of range.");
+  }
+
+  return *slot(index);
+}
+
+template <typename T, typename CheckPolicy>
+const T &SegmentedArray<T, CheckPolicy>::at(int index) const
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw std::out_of_range("Index of array is out of range.");
+  }
+
+  return *slot(index);
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::findIndex(const T &item) const
+{
+  int start = 0;
+
+  // Each block is contiguous, so it is searched as one run
+  for (int block = 0; block < blockCount && start <= lastIndex; block++)
+  {
+    int length = lastIndex + 1 - start;
+    if (blockSize(block) < static_cast<std::size_t>(length))
+    {
+      length = static_cast<int>(blockSize(block));
+    }
+
+    if constexpr (simd::IsSearchable<T>::value)
+    {
+      int found = simd::findFirst(blocks[block], length, item);
+      if (found != -1)
+      {
+        return start + found;
+      }
+    }
+    else
+    {
+      for (int i = 0; i < length; i++)
+      {
+        if (blocks[block][i] == item)
+        {
+          return start + i;
+        }
+      }
+    }
+
+    start += length;
+  }
+  return -1;
+}
+
+template <typename T, typename CheckPolicy>
+bool SegmentedArray<T, CheckPolicy>::isEmpty() const
+{
+  return lastIndex == -1;
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::countItems() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::getCapacity() const
+{
+  // Blocks 0..k-1 hold 16 * (2^k - 1) items together
+  std::size_t total = blockSize(blockCount) - FIRST_BLOCK;
+  return total > INT_MAX ? INT_MAX : static_cast<int>(total);
+}
+
+template <typename T, typename CheckPolicy>
+void SegmentedArray<T, CheckPolicy>::display() const
+{
+  std::cout << "[";
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    std::cout << *slot(i) << (i == lastIndex ? "" : ", ");
+  }
+  std::cout << "]";
+}
+
+template <typename T, typename CheckPolicy>
+int SegmentedArray<T, CheckPolicy>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, typename CheckPolicy>
+typename SegmentedArray<T, CheckPolicy>::iterator SegmentedArray<T, CheckPolicy>::begin()
+{
+  return iterator(this, 0);
+}
+
+template <typename T, typename CheckPolicy>
+typename SegmentedArray<T, CheckPolicy>::iterator SegmentedArray<T, CheckPolicy>::end()
+{
+  return iterator(this, lastIndex + 1);
+}
+
+template <typename T, typename CheckPolicy>
+typename SegmentedArray<T, CheckPolicy>::const_iterator SegmentedArray<T, CheckPolicy>::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+template <typename T, typename CheckPolicy>
+typename SegmentedArray<T, CheckPolicy>::const_iterator SegmentedArray<T, CheckPolicy>::end() const
+{
+  return const_iterator(this, lastIndex + 1);
+}
+
+#endif
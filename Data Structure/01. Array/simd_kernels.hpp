@@ -0,0 +1,386 @@
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMD_KERNELS_X86 1
+#endif
+
+#ifndef SIMD_KERNELS_HPP
+
+#define SIMD_KERNELS_HPP
+
+// Vectorized search kernels shared by Array and DynArray.
+//
+// Every kernel walks the data in 16 byte (SSE2) or 32 byte (AVX2) blocks and
+// reduces the comparison of a block to a bit mask with one bit per byte, so a
+// matching item of size W shows up as W consecutive set bits. The best
+// instruction set is picked once at runtime; other CPUs use a scalar walker
+// that builds the same masks.
+namespace simd
+{
+  // Types the kernels handle; anything else keeps its scalar operator== loop
+  template <typename T>
+  struct IsSearchable
+      : std::integral_constant<bool, (std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) ||
+                                         std::is_same<T, float>::value || std::is_same<T, double>::value>
+  {
+  };
+
+  // Largest number of needles compared in one pass over the data
+  const int MAX_NEEDLES = 8;
+
+  enum class Isa
+  {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+  };
+
+  inline Isa detectIsa()
+  {
+#ifdef SIMD_KERNELS_X86
+    static const Isa isa = []
+    {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f"))
+      {
+        return Isa::AVX512;
+      }
+      if (__builtin_cpu_supports("avx2"))
+      {
+        return Isa::AVX2;
+      }
+      if (__builtin_cpu_supports("sse2"))
+      {
+        return Isa::SSE2;
+      }
+      return Isa::Scalar;
+    }();
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+  }
+
+  // Mask of the 'sizeof(T)' bits that belong to one item
+  template <typename T>
+  inline unsigned itemBits()
+  {
+    return (1u << sizeof(T)) - 1;
+  }
+
+  // Scalar mask for up to 'count' items starting at 'data'
+  template <typename T>
+  inline unsigned scalarMask(const T *data, int count, const T *needles, int needleCount)
+  {
+    unsigned mask = 0;
+    for (int i = 0; i < count; i++)
+    {
+      for (int j = 0; j < needleCount; j++)
+      {
+        if (data[i] == needles[j])
+        {
+          mask |= itemBits<T>() << (i * sizeof(T));
+          break;
+        }
+      }
+    }
+    return mask;
+  }
+
+  // Calls visit(mask, baseIndex) for each block until it returns false.
+  // Returns false if the visitor stopped the walk early.
+  template <typename T, typename Visitor>
+  bool walkScalar(const T *data, int n, const T *needles, int needleCount, Visitor &visit)
+  {
+    const int step = 16 / sizeof(T);
+    for (int i = 0; i < n; i += step)
+    {
+      int count = n - i < step ? n - i : step;
+      unsigned mask = scalarMask(data + i, count, needles, needleCount);
+      if (mask != 0 && !visit(mask, i))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+#ifdef SIMD_KERNELS_X86
+  template <typename T>
+  __attribute__((target("sse2"))) inline __m128i broadcast128(T value)
+  {
+    T lanes[16 / sizeof(T)];
+    for (auto &lane : lanes)
+    {
+      lane = value;
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes));
+  }
+
+  template <typename T>
+  __attribute__((target("sse2"))) inline __m128i equal128(__m128i block, __m128i needle)
+  {
+    if constexpr (std::is_same<T, float>::value)
+    {
+      return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+    }
+    else if constexpr (std::is_same<T, double>::value)
+    {
+      return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+    }
+    else if constexpr (sizeof(T) == 1)
+    {
+      return _mm_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+      return _mm_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+      return _mm_cmpeq_epi32(block, needle);
+    }
+    else
+    {
+      // SSE2 has no 64-bit compare: both 32-bit halves have to match
+      __m128i halves = _mm_cmpeq_epi32(block, needle);
+      return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+  }
+
+  template <typename T, typename Visitor>
+  __attribute__((target("sse2"))) bool walkSSE2(const T *data, int n, const T *needles, int needleCount, Visitor &visit)
+  {
+    const int step = 16 / sizeof(T);
+    __m128i broadcast[MAX_NEEDLES];
+    for (int j = 0; j < needleCount; j++)
+    {
+      broadcast[j] = broadcast128(needles[j]);
+    }
+
+    int i = 0;
+    for (; i + step <= n; i += step)
+    {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+      __m128i hits = equal128<T>(block, broadcast[0]);
+      for (int j = 1; j < needleCount; j++)
+      {
+        hits = _mm_or_si128(hits, equal128<T>(block, broadcast[j]));
+      }
+
+      unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+      if (mask != 0 && !visit(mask, i))
+      {
+        return false;
+      }
+    }
+
+    unsigned mask = scalarMask(data + i, n - i, needles, needleCount);
+    return mask == 0 || visit(mask, i);
+  }
+
+  template <typename T>
+  __attribute__((target("avx2"))) inline __m256i broadcast256(T value)
+  {
+    T lanes[32 / sizeof(T)];
+    for (auto &lane : lanes)
+    {
+      lane = value;
+    }
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+  }
+
+  template <typename T>
+  __attribute__((target("avx2"))) inline __m256i equal256(__m256i block, __m256i needle)
+  {
+    if constexpr (std::is_same<T, float>::value)
+    {
+      return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(needle), _CMP_EQ_OQ));
+    }
+    else if constexpr (std::is_same<T, double>::value)
+    {
+      return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(needle), _CMP_EQ_OQ));
+    }
+    else if constexpr (sizeof(T) == 1)
+    {
+      return _mm256_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+      return _mm256_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+      return _mm256_cmpeq_epi32(block, needle);
+    }
+    else
+    {
+      return _mm256_cmpeq_epi64(block, needle);
+    }
+  }
+
+  template <typename T, typename Visitor>
+  __attribute__((target("avx2"))) bool walkAVX2(const T *data, int n, const T *needles, int needleCount, Visitor &visit)
+  {
+    const int step = 32 / sizeof(T);
+    __m256i broadcast[MAX_NEEDLES];
+    for (int j = 0; j < needleCount; j++)
+    {
+      broadcast[j] = broadcast256(needles[j]);
+    }
+
+    int i = 0;
+    for (; i + step <= n; i += step)
+    {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+      __m256i hits = equal256<T>(block, broadcast[0]);
+      for (int j = 1; j < needleCount; j++)
+      {
+        hits = _mm256_or_si256(hits, equal256<T>(block, broadcast[j]));
+      }
+
+      unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+      if (mask != 0 && !visit(mask, i))
+      {
+        return false;
+      }
+    }
+
+    // The tail is shorter than a 32 byte block
+    unsigned mask = scalarMask(data + i, n - i, needles, needleCount);
+    return mask == 0 || visit(mask, i);
+  }
+#endif
+
+  // Walks the data with the best available instruction set
+  template <typename T, typename Visitor>
+  bool walk(const T *data, int n, const T *needles, int needleCount, Visitor &visit)
+  {
+#ifdef SIMD_KERNELS_X86
+    switch (detectIsa())
+    {
+    // The search masks are built 32 bytes at a time on AVX-512 CPUs too
+    case Isa::AVX512:
+    case Isa::AVX2:
+      return walkAVX2(data, n, needles, needleCount, visit);
+    case Isa::SSE2:
+      return walkSSE2(data, n, needles, needleCount, visit);
+    default:
+      break;
+    }
+#endif
+    return walkScalar(data, n, needles, needleCount, visit);
+  }
+
+  // Index of the first item equal to 'value', otherwise -1
+  template <typename T>
+  int findFirst(const T *data, int n, T value)
+  {
+    int found = -1;
+    auto visit = [&found](unsigned mask, int base)
+    {
+      found = base + __builtin_ctz(mask) / static_cast<int>(sizeof(T));
+      return false;
+    };
+    walk(data, n, &value, 1, visit);
+    return found;
+  }
+
+  // Number of items equal to 'value'
+  template <typename T>
+  int count(const T *data, int n, T value)
+  {
+    int total = 0;
+    auto visit = [&total](unsigned mask, int)
+    {
+      total += __builtin_popcount(mask) / static_cast<int>(sizeof(T));
+      return true;
+    };
+    walk(data, n, &value, 1, visit);
+    return total;
+  }
+
+  // Calls found(index) for every item equal to 'value', in order
+  template <typename T, typename Callback>
+  void forEachMatch(const T *data, int n, T value, Callback found)
+  {
+    auto visit = [&found](unsigned mask, int base)
+    {
+      while (mask != 0)
+      {
+        int bit = __builtin_ctz(mask);
+        found(base + bit / static_cast<int>(sizeof(T)));
+        mask &= ~(itemBits<T>() << bit);
+      }
+      return true;
+    };
+    walk(data, n, &value, 1, visit);
+  }
+
+  // Set bits in 'n' 64-bit words. The POPCNT version is used when the CPU
+  // has it, so the count is one instruction per word even in a generic build.
+  inline int popcountScalar(const std::uint64_t *words, int n)
+  {
+    int total = 0;
+    for (int i = 0; i < n; i++)
+    {
+      total += __builtin_popcountll(words[i]);
+    }
+    return total;
+  }
+
+#ifdef SIMD_KERNELS_X86
+  __attribute__((target("popcnt"))) inline int popcountHardware(const std::uint64_t *words, int n)
+  {
+    int total = 0;
+    for (int i = 0; i < n; i++)
+    {
+      total += __builtin_popcountll(words[i]);
+    }
+    return total;
+  }
+#endif
+
+  inline int popcount(const std::uint64_t *words, int n)
+  {
+#ifdef SIMD_KERNELS_X86
+    static const bool hasPopcnt = []
+    {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("popcnt") != 0;
+    }();
+
+    if (hasPopcnt)
+    {
+      return popcountHardware(words, n);
+    }
+#endif
+    return popcountScalar(words, n);
+  }
+
+  // True if any item equals any of the needles
+  template <typename T>
+  bool containsAny(const T *data, int n, const T *needles, int needleCount)
+  {
+    auto visit = [](unsigned, int)
+    {
+      return false;
+    };
+
+    for (int j = 0; j < needleCount; j += MAX_NEEDLES)
+    {
+      int group = needleCount - j < MAX_NEEDLES ? needleCount - j : MAX_NEEDLES;
+      if (!walk(data, n, needles + j, group, visit))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+#endif
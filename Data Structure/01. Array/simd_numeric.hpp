@@ -0,0 +1,611 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "custom_exception"
+#include "simd_kernels.hpp"
+#include "dynamic_array.cpp"
+
+#ifndef SIMD_NUMERIC_HPP
+
+#define SIMD_NUMERIC_HPP
+
+// Vectorized reductions and element-wise kernels for numeric items
+// (int32_t, int64_t, float and double).
+//
+// Each kernel is written once with GCC vector types and compiled three times,
+// for 16 byte (SSE2), 32 byte (AVX2) and 64 byte (AVX-512) vectors; the widest
+// one the CPU supports is picked at runtime like the search kernels. The
+// floating point kernels reorder additions across lanes, so their results can
+// differ from a left-to-right loop in the last bits. NaN items give
+// unspecified min/max results.
+namespace simd
+{
+  template <typename T>
+  struct IsNumeric
+      : std::integral_constant<bool, std::is_same<T, std::int32_t>::value || std::is_same<T, std::int64_t>::value ||
+                                         std::is_same<T, float>::value || std::is_same<T, double>::value>
+  {
+  };
+
+  // Integers are summed in 64 bits, so a sum of int32_t items cannot overflow
+  template <typename T>
+  using SumType = typename std::conditional<std::is_floating_point<T>::value, T, std::int64_t>::type;
+
+  enum class Summation
+  {
+    // Lane-parallel running sums; fastest, error grows with n
+    Naive,
+    // Recursive halving down to small blocks; error grows with log(n)
+    Pairwise,
+    // Compensated sum per lane; error independent of n, about 2x the work
+    Kahan
+  };
+
+  template <typename T, int Bytes>
+  struct Vector
+  {
+    typedef T type __attribute__((vector_size(Bytes)));
+  };
+
+  // Unaligned load and store. Vectors are passed by reference so that no
+  // function signature depends on the vector ABI of the build flags.
+  template <typename V, typename T>
+  __attribute__((always_inline)) inline void loadVector(V &v, const T *data)
+  {
+    std::memcpy(&v, data, sizeof(V));
+  }
+
+  template <typename V, typename T>
+  __attribute__((always_inline)) inline void storeVector(T *data, const V &v)
+  {
+    std::memcpy(data, &v, sizeof(V));
+  }
+
+  // The kernels below are only ever inlined into the per-ISA entry points,
+  // which decide the instructions they compile to.
+
+  // Four independent accumulators, so consecutive adds do not wait on each other
+  template <typename T>
+  struct SumKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline SumType<T> run(const T *data, int n)
+    {
+      typedef SumType<T> S;
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+      typedef typename Vector<S, LANES * sizeof(S)>::type A;
+
+      A acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+      V x0, x1, x2, x3;
+      int i = 0;
+      for (; i + 4 * LANES <= n; i += 4 * LANES)
+      {
+        loadVector(x0, data + i);
+        loadVector(x1, data + i + LANES);
+        loadVector(x2, data + i + 2 * LANES);
+        loadVector(x3, data + i + 3 * LANES);
+        acc0 += __builtin_convertvector(x0, A);
+        acc1 += __builtin_convertvector(x1, A);
+        acc2 += __builtin_convertvector(x2, A);
+        acc3 += __builtin_convertvector(x3, A);
+      }
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x0, data + i);
+        acc0 += __builtin_convertvector(x0, A);
+      }
+
+      A total = (acc0 + acc1) + (acc2 + acc3);
+      S sum = 0;
+      for (int j = 0; j < LANES; j++)
+      {
+        sum += total[j];
+      }
+      for (; i < n; i++)
+      {
+        sum += data[i];
+      }
+      return sum;
+    }
+  };
+
+  // Kahan summation carried out independently in every lane
+  template <typename T>
+  struct KahanKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline T run(const T *data, int n)
+    {
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+
+      V sum = {}, lost = {}, x;
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x, data + i);
+        V y = x - lost;
+        V t = sum + y;
+        lost = (t - sum) - y;
+        sum = t;
+      }
+
+      // Fold the lanes and the tail with the same compensation
+      T total = 0, error = 0;
+      auto add = [&total, &error](T x)
+      {
+        T y = x - error;
+        T t = total + y;
+        error = (t - total) - y;
+        total = t;
+      };
+      for (int j = 0; j < LANES; j++)
+      {
+        add(sum[j]);
+        add(-lost[j]);
+      }
+      for (; i < n; i++)
+      {
+        add(data[i]);
+      }
+      return total;
+    }
+  };
+
+  // Smallest and largest item in one pass; n must be at least 1
+  template <typename T>
+  struct MinMaxKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline void run(const T *data, int n, T *low, T *high)
+    {
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+
+      V lo = V{} + data[0];
+      V hi = lo;
+      V x;
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x, data + i);
+        lo = x < lo ? x : lo;
+        hi = x > hi ? x : hi;
+      }
+
+      T minimum = lo[0], maximum = hi[0];
+      for (int j = 1; j < LANES; j++)
+      {
+        minimum = lo[j] < minimum ? lo[j] : minimum;
+        maximum = hi[j] > maximum ? hi[j] : maximum;
+      }
+      for (; i < n; i++)
+      {
+        minimum = data[i] < minimum ? data[i] : minimum;
+        maximum = data[i] > maximum ? data[i] : maximum;
+      }
+
+      *low = minimum;
+      *high = maximum;
+    }
+  };
+
+  // Items within [low, high]
+  template <typename T>
+  struct CountInRangeKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline int run(const T *data, int n, T low, T high)
+    {
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+      typedef decltype(V{} < V{}) Mask;
+
+      V lo = V{} + low;
+      V hi = V{} + high;
+
+      // A true comparison is -1 in its lane, so subtracting the mask counts
+      Mask counts = {};
+      V x;
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x, data + i);
+        counts -= (x >= lo) & (x <= hi);
+      }
+
+      int total = 0;
+      for (int j = 0; j < LANES; j++)
+      {
+        total += static_cast<int>(counts[j]);
+      }
+      for (; i < n; i++)
+      {
+        total += data[i] >= low && data[i] <= high;
+      }
+      return total;
+    }
+  };
+
+  // Sum of x[i] * y[i]
+  template <typename T>
+  struct DotKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline SumType<T> run(const T *x, const T *y, int n)
+    {
+      typedef SumType<T> S;
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+      typedef typename Vector<S, LANES * sizeof(S)>::type A;
+
+      A acc0 = {}, acc1 = {};
+      V x0, y0, x1, y1;
+      int i = 0;
+      for (; i + 2 * LANES <= n; i += 2 * LANES)
+      {
+        loadVector(x0, x + i);
+        loadVector(y0, y + i);
+        loadVector(x1, x + i + LANES);
+        loadVector(y1, y + i + LANES);
+        acc0 += __builtin_convertvector(x0, A) * __builtin_convertvector(y0, A);
+        acc1 += __builtin_convertvector(x1, A) * __builtin_convertvector(y1, A);
+      }
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x0, x + i);
+        loadVector(y0, y + i);
+        acc0 += __builtin_convertvector(x0, A) * __builtin_convertvector(y0, A);
+      }
+
+      A total = acc0 + acc1;
+      S sum = 0;
+      for (int j = 0; j < LANES; j++)
+      {
+        sum += total[j];
+      }
+      for (; i < n; i++)
+      {
+        sum += static_cast<S>(x[i]) * static_cast<S>(y[i]);
+      }
+      return sum;
+    }
+  };
+
+  // dest[i] = a * source[i] + b; dest may be source
+  template <typename T>
+  struct ScaleAddKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline void run(T *dest, const T *source, int n, T a, T b)
+    {
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+
+      V scale = V{} + a;
+      V offset = V{} + b;
+      V x;
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(x, source + i);
+        x = x * scale + offset;
+        storeVector(dest + i, x);
+      }
+      for (; i < n; i++)
+      {
+        dest[i] = a * source[i] + b;
+      }
+    }
+  };
+
+  // dest[i] += x[i] * y[i]; may compile to FMA instructions, which round once
+  // instead of twice
+  template <typename T>
+  struct MultiplyAddKernel
+  {
+    template <int Bytes>
+    __attribute__((always_inline)) static inline void run(T *dest, const T *x, const T *y, int n)
+    {
+      const int LANES = Bytes / sizeof(T);
+      typedef typename Vector<T, Bytes>::type V;
+
+      V sum, a, b;
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        loadVector(sum, dest + i);
+        loadVector(a, x + i);
+        loadVector(b, y + i);
+        sum += a * b;
+        storeVector(dest + i, sum);
+      }
+      for (; i < n; i++)
+      {
+        dest[i] += x[i] * y[i];
+      }
+    }
+  };
+
+#ifdef SIMD_KERNELS_X86
+  template <typename Kernel, typename... Args>
+  __attribute__((target("sse2"))) auto runSSE2(Args... args)
+  {
+    return Kernel::template run<16>(args...);
+  }
+
+  template <typename Kernel, typename... Args>
+  __attribute__((target("avx2"))) auto runAVX2(Args... args)
+  {
+    return Kernel::template run<32>(args...);
+  }
+
+  template <typename Kernel, typename... Args>
+  __attribute__((target("avx512f"))) auto runAVX512(Args... args)
+  {
+    return Kernel::template run<64>(args...);
+  }
+#endif
+
+  // Runs the kernel with the widest vectors the CPU supports
+  template <typename Kernel, typename... Args>
+  auto runKernel(Args... args)
+  {
+#ifdef SIMD_KERNELS_X86
+    switch (detectIsa())
+    {
+    case Isa::AVX512:
+      return runAVX512<Kernel>(args...);
+    case Isa::AVX2:
+      return runAVX2<Kernel>(args...);
+    case Isa::SSE2:
+      return runSSE2<Kernel>(args...);
+    default:
+      break;
+    }
+#endif
+    // Generic 16 byte vectors, lowered to whatever the target has
+    return Kernel::template run<16>(args...);
+  }
+
+  template <typename T>
+  SumType<T> pairwiseSum(const T *data, int n)
+  {
+    // Blocks this small are summed directly by the vector kernel
+    const int BLOCK = 1024;
+
+    if (n <= BLOCK)
+    {
+      return runKernel<SumKernel<T>>(data, n);
+    }
+
+    int half = n / 2;
+    return pairwiseSum(data, half) + pairwiseSum(data + half, n - half);
+  }
+
+  template <typename T>
+  SumType<T> sum(const T *data, int n, Summation method = Summation::Pairwise)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    // Integer sums are exact whatever the order
+    if constexpr (std::is_floating_point<T>::value)
+    {
+      if (method == Summation::Pairwise)
+      {
+        return pairwiseSum(data, n);
+      }
+      if (method == Summation::Kahan)
+      {
+        return runKernel<KahanKernel<T>>(data, n);
+      }
+    }
+    return runKernel<SumKernel<T>>(data, n);
+  }
+
+  // Stores the smallest and largest item; n must be at least 1
+  template <typename T>
+  void minMax(const T *data, int n, T *low, T *high)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    runKernel<MinMaxKernel<T>>(data, n, low, high);
+  }
+
+  // Index of the first smallest / largest item, otherwise -1. The value is
+  // found by a reduction and its position by the search kernel.
+  template <typename T>
+  int argMin(const T *data, int n)
+  {
+    if (n < 1)
+    {
+      return -1;
+    }
+
+    T low, high;
+    minMax(data, n, &low, &high);
+    return findFirst(data, n, low);
+  }
+
+  template <typename T>
+  int argMax(const T *data, int n)
+  {
+    if (n < 1)
+    {
+      return -1;
+    }
+
+    T low, high;
+    minMax(data, n, &low, &high);
+    return findFirst(data, n, high);
+  }
+
+  template <typename T>
+  int countInRange(const T *data, int n, T low, T high)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    return runKernel<CountInRangeKernel<T>>(data, n, low, high);
+  }
+
+  template <typename T>
+  SumType<T> dot(const T *x, const T *y, int n)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    return runKernel<DotKernel<T>>(x, y, n);
+  }
+
+  template <typename T>
+  void scaleAdd(T *dest, const T *source, int n, T a, T b)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    runKernel<ScaleAddKernel<T>>(dest, source, n, a, b);
+  }
+
+  template <typename T>
+  void multiplyAdd(T *dest, const T *x, const T *y, int n)
+  {
+    static_assert(IsNumeric<T>::value, "Numeric kernels take int32_t, int64_t, float or double items.");
+
+    runKernel<MultiplyAddKernel<T>>(dest, x, y, n);
+  }
+
+  // Adds every item within [low, high] to one of 'bins' equal width bins
+  // (the top edge goes to the last bin); needs low < high with a finite
+  // width. NaN items are skipped. Scattered increments do not vectorize, so
+  // this is a plain loop.
+  template <typename T>
+  void histogram(const T *data, int n, T low, T high, int bins, int *counts)
+  {
+    double scale = bins / (static_cast<double>(high) - static_cast<double>(low));
+
+    for (int i = 0; i < n; i++)
+    {
+      // Written so that NaN fails the test too
+      if (!(data[i] >= low && data[i] <= high))
+      {
+        continue;
+      }
+
+      int bin = static_cast<int>((static_cast<double>(data[i]) - static_cast<double>(low)) * scale);
+      counts[bin < bins ? bin : bins - 1]++;
+    }
+  }
+}
+
+// The numeric kernels applied to any array with contiguous storage (Array,
+// DynArray, SmallDynArray, StaticArray, MmapArray, ...), without copying or
+// bounds checking each item.
+namespace numeric
+{
+  template <typename Container>
+  using ItemType = typename std::remove_cv<typename std::remove_pointer<decltype(std::declval<const Container &>().data())>::type>::type;
+
+  template <typename Container>
+  simd::SumType<ItemType<Container>> sum(const Container &items, simd::Summation method = simd::Summation::Pairwise)
+  {
+    return simd::sum(items.data(), items.size(), method);
+  }
+
+  template <typename Container>
+  std::pair<ItemType<Container>, ItemType<Container>> minMax(const Container &items)
+  {
+    if (items.size() == 0)
+    {
+      throw ArrayUnderflow("Cannot find the extremes of an empty array.");
+    }
+
+    ItemType<Container> low, high;
+    simd::minMax(items.data(), items.size(), &low, &high);
+    return std::make_pair(low, high);
+  }
+
+  template <typename Container>
+  ItemType<Container> min(const Container &items)
+  {
+    return minMax(items).first;
+  }
+
+  template <typename Container>
+  ItemType<Container> max(const Container &items)
+  {
+    return minMax(items).second;
+  }
+
+  // -1 for an empty array
+  template <typename Container>
+  int argMin(const Container &items)
+  {
+    return simd::argMin(items.data(), items.size());
+  }
+
+  template <typename Container>
+  int argMax(const Container &items)
+  {
+    return simd::argMax(items.data(), items.size());
+  }
+
+  template <typename Container>
+  int countInRange(const Container &items, ItemType<Container> low, ItemType<Container> high)
+  {
+    return simd::countInRange(items.data(), items.size(), low, high);
+  }
+
+  // Counts of the items in 'bins' equal width bins over [low, high]
+  template <typename Container>
+  DynArray<int> histogram(const Container &items, ItemType<Container> low, ItemType<Container> high, int bins)
+  {
+    // The width is infinite when a bound is, and NaN when one is NaN
+    if (bins < 1 || !(low < high) || !std::isfinite(static_cast<double>(high) - static_cast<double>(low)))
+    {
+      throw std::invalid_argument("Histogram needs at least one bin and finite bounds with low < high.");
+    }
+
+    DynArray<int> counts(bins);
+    for (int i = 0; i < bins; i++)
+    {
+      counts.append(0);
+    }
+
+    simd::histogram(items.data(), items.size(), low, high, bins, counts.data());
+    return counts;
+  }
+
+  template <typename X, typename Y>
+  simd::SumType<ItemType<X>> dot(const X &x, const Y &y)
+  {
+    if (x.size() != y.size())
+    {
+      throw std::invalid_argument("Both arrays must hold the same number of items.");
+    }
+
+    return simd::dot(x.data(), y.data(), x.size());
+  }
+
+  // items[i] = a * items[i] + b in one pass
+  template <typename Container>
+  void scaleAdd(Container &items, ItemType<Container> a, ItemType<Container> b)
+  {
+    simd::scaleAdd(items.data(), items.data(), items.size(), a, b);
+  }
+
+  // dest[i] += x[i] * y[i] in one pass
+  template <typename Container, typename X, typename Y>
+  void multiplyAdd(Container &dest, const X &x, const Y &y)
+  {
+    if (dest.size() != x.size() || dest.size() != y.size())
+    {
+      throw std::invalid_argument("All arrays must hold the same number of items.");
+    }
+
+    simd::multiplyAdd(dest.data(), x.data(), y.data(), dest.size());
+  }
+}
+
+#endif
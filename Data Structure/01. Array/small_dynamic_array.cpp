@@ -0,0 +1,552 @@
+#ifndef SMALL_DYNAMIC_ARRAY_CPP
+
+#define SMALL_DYNAMIC_ARRAY_CPP
+
+#include "dynamic_array.cpp"
+
+// Dynamic array that keeps up to N items inside the object itself and only
+// moves them to the heap once an append goes past N.
+template <typename T, int N, typename GrowthPolicy = DoublingGrowth, typename CheckPolicy = Checked>
+class SmallDynArray
+{
+  static_assert(N > 0, "Inline capacity must be 1 or more.");
+
+private:
+  int capacity;
+  int lastIndex;
+
+  // Points to 'buffer' while the items fit in it, otherwise to a heap block
+  T *ptr;
+  alignas(T) unsigned char buffer[N * sizeof(T)];
+
+  T *inlineData();
+  bool isInline() const;
+
+  // Moves the live items into 'dest' and ends their lifetime here
+  void relocateTo(T *);
+
+  // Moves the items to a heap block of the given capacity, or back into the
+  // inline buffer if it is big enough
+  void reallocate(int);
+
+  // Takes over the items of a moved-from array
+  void steal(SmallDynArray &);
+
+protected:
+  bool isFull() const;
+  void clear();
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallDynArray();
+  ~SmallDynArray();
+  SmallDynArray(const SmallDynArray &);
+  SmallDynArray(SmallDynArray &&) noexcept(std::is_nothrow_move_constructible<T>::value);
+  SmallDynArray &operator=(const SmallDynArray &);
+  SmallDynArray &operator=(SmallDynArray &&) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+  void append(const T &);
+  void append(T &&);
+  void insert(const T &, int);
+  void insert(T &&, int);
+  void remove(int);
+  void replace(const T &, int);
+
+  // Grows the capacity to at least the given number of items
+  void reserve(int);
+
+  // Releases unused heap capacity, moving back inline when the items fit
+  void shrink_to_fit();
+
+  template <typename... Args>
+  T &emplace_back(Args &&...);
+
+  template <typename... Args>
+  T &emplace(int, Args &&...);
+
+  bool isEmpty() const;
+  int countItems() const;
+  T getItem(int) const;
+
+  // Reference access; operator[] follows CheckPolicy, at() always throws
+  T &operator[](int);
+  const T &operator[](int) const;
+  T &at(int);
+  const T &at(int) const;
+
+  int findIndex(const T &) const;
+  int getCapacity() const;
+
+  // Points into the inline buffer while the items still fit there
+  T *data();
+  const T *data() const;
+  int size() const;
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+};
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+T *SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::inlineData()
+{
+  return reinterpret_cast<T *>(buffer);
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+bool SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::isInline() const
+{
+  return ptr == reinterpret_cast<const T *>(buffer);
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::relocateTo(T *dest)
+{
+  if constexpr (IsTriviallyRelocatable<T>::value)
+  {
+    if (lastIndex >= 0)
+    {
+      std::memcpy(static_cast<void *>(dest), static_cast<const void *>(ptr), (lastIndex + 1) * sizeof(T));
+    }
+  }
+  else
+  {
+    if constexpr (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+    {
+      std::uninitialized_move_n(ptr, lastIndex + 1, dest);
+    }
+    else
+    {
+      std::uninitialized_copy_n(ptr, lastIndex + 1, dest);
+    }
+
+    std::destroy_n(ptr, lastIndex + 1);
+  }
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::reallocate(int newCapacity)
+{
+  bool toInline = newCapacity <= N;
+  T *temp = toInline ? inlineData() : static_cast<T *>(::operator new(static_cast<std::size_t>(newCapacity) * sizeof(T)));
+
+  try
+  {
+    relocateTo(temp);
+  }
+  catch (...)
+  {
+    if (!toInline)
+    {
+      ::operator delete(temp);
+    }
+    throw;
+  }
+
+  if (!isInline())
+  {
+    ::operator delete(ptr);
+  }
+
+  ptr = temp;
+  capacity = toInline ? N : newCapacity;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::steal(SmallDynArray &obj)
+{
+  if (obj.isInline())
+  {
+    std::uninitialized_move_n(obj.ptr, obj.lastIndex + 1, inlineData());
+    ptr = inlineData();
+    capacity = N;
+    lastIndex = obj.lastIndex;
+    obj.clear();
+  }
+  else
+  {
+    ptr = obj.ptr;
+    capacity = obj.capacity;
+    lastIndex = obj.lastIndex;
+
+    obj.ptr = obj.inlineData();
+    obj.capacity = N;
+    obj.lastIndex = -1;
+  }
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::SmallDynArray()
+{
+  capacity = N;
+  lastIndex = -1;
+  ptr = inlineData();
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::~SmallDynArray()
+{
+  clear();
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::SmallDynArray(const SmallDynArray &obj)
+{
+  lastIndex = -1;
+  ptr = inlineData();
+
+  if (obj.lastIndex + 1 > N)
+  {
+    // Only as much heap as the items need
+    capacity = obj.lastIndex + 1;
+    ptr = static_cast<T *>(::operator new(static_cast<std::size_t>(capacity) * sizeof(T)));
+  }
+  else
+  {
+    capacity = N;
+  }
+
+  try
+  {
+    std::uninitialized_copy_n(obj.ptr, obj.lastIndex + 1, ptr);
+  }
+  catch (...)
+  {
+    if (!isInline())
+    {
+      ::operator delete(ptr);
+    }
+    throw;
+  }
+
+  lastIndex = obj.lastIndex;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::SmallDynArray(SmallDynArray &&obj) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+  steal(obj);
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy> &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::operator=(const SmallDynArray &obj)
+{
+  if (this != &obj)
+  {
+    SmallDynArray temp(obj);
+    clear();
+    steal(temp);
+  }
+
+  return *this;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+SmallDynArray<T, N, GrowthPolicy, CheckPolicy> &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::operator=(SmallDynArray &&obj) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+  if (this != &obj)
+  {
+    clear();
+    steal(obj);
+  }
+
+  return *this;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::clear()
+{
+  std::destroy_n(ptr, lastIndex + 1);
+
+  if (!isInline())
+  {
+    ::operator delete(ptr);
+  }
+
+  ptr = inlineData();
+  capacity = N;
+  lastIndex = -1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+template <typename... Args>
+T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::emplace_back(Args &&...args)
+{
+  if (!isFull())
+  {
+    ::new (static_cast<void *>(ptr + lastIndex + 1)) T(std::forward<Args>(args)...);
+    lastIndex++;
+    return ptr[lastIndex];
+  }
+
+  // Spill to the heap; the new item is built first in case the arguments
+  // refer to an element of this array
+  int newCapacity = GrowthPolicy::grow(capacity, sizeof(T));
+  T *temp = static_cast<T *>(::operator new(static_cast<std::size_t>(newCapacity) * sizeof(T)));
+
+  try
+  {
+    ::new (static_cast<void *>(temp + lastIndex + 1)) T(std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    ::operator delete(temp);
+    throw;
+  }
+
+  try
+  {
+    relocateTo(temp);
+  }
+  catch (...)
+  {
+    temp[lastIndex + 1].~T();
+    ::operator delete(temp);
+    throw;
+  }
+
+  if (!isInline())
+  {
+    ::operator delete(ptr);
+  }
+
+  ptr = temp;
+  capacity = newCapacity;
+  lastIndex++;
+  return ptr[lastIndex];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+template <typename... Args>
+T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::emplace(int index, Args &&...args)
+{
+  if (index < 0 || index > lastIndex + 1)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  if (index == lastIndex + 1)
+  {
+    return emplace_back(std::forward<Args>(args)...);
+  }
+
+  T item(std::forward<Args>(args)...);
+
+  if (isFull())
+  {
+    reallocate(GrowthPolicy::grow(capacity, sizeof(T)));
+  }
+
+  ::new (static_cast<void *>(ptr + lastIndex + 1)) T(std::move(ptr[lastIndex]));
+  lastIndex++;
+
+  for (int i = lastIndex - 1; i > index; i--)
+  {
+    ptr[i] = std::move(ptr[i - 1]);
+  }
+
+  ptr[index] = std::move(item);
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::append(const T &item)
+{
+  emplace_back(item);
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::append(T &&item)
+{
+  emplace_back(std::move(item));
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::insert(const T &item, int index)
+{
+  emplace(index, item);
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::insert(T &&item, int index)
+{
+  emplace(index, std::move(item));
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::replace(const T &item, int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  ptr[index] = item;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::remove(int index)
+{
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
+
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  for (int i = index; i < lastIndex; i++)
+  {
+    ptr[i] = std::move(ptr[i + 1]);
+  }
+
+  ptr[lastIndex].~T();
+  lastIndex--;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::reserve(int size)
+{
+  if (size > capacity)
+  {
+    reallocate(size);
+  }
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+void SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::shrink_to_fit()
+{
+  if (!isInline() && lastIndex + 1 < capacity)
+  {
+    reallocate(lastIndex < 0 ? 1 : lastIndex + 1);
+  }
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+bool SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::isEmpty() const
+{
+  return lastIndex == -1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+bool SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::isFull() const
+{
+  return lastIndex + 1 == capacity;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+int SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::countItems() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+T SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+const T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index of array is out of range.");
+
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::at(int index)
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+const T &SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::at(int index) const
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index of array is out of range.");
+  }
+
+  return ptr[index];
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+int SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::findIndex(const T &item) const
+{
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (ptr[i] == item)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+int SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::getCapacity() const
+{
+  return capacity;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+T *SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::data()
+{
+  return ptr;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+const T *SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::data() const
+{
+  return ptr;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+int SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+typename SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::iterator SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::begin()
+{
+  return ptr;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+typename SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::iterator SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::end()
+{
+  return ptr + lastIndex + 1;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+typename SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::const_iterator SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::begin() const
+{
+  return ptr;
+}
+
+template <typename T, int N, typename GrowthPolicy, typename CheckPolicy>
+typename SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::const_iterator SmallDynArray<T, N, GrowthPolicy, CheckPolicy>::end() const
+{
+  return ptr + lastIndex + 1;
+}
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef SOA_ARRAY_CPP
+
+#define SOA_ARRAY_CPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "dynamic_array.cpp"
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+// Structure of arrays: every field of a row is stored in its own contiguous
+// column, so a scan over one field only reads that field's bytes instead of
+// whole records. Columns are cache line aligned DynArrays, which suits the
+// SIMD kernels and the standard algorithms alike. Rows are read and written
+// through tuples; row(i) returns a tuple of references into the columns.
+template <typename... Fields>
+class SoAArray
+{
+  static_assert(sizeof...(Fields) > 0, "SoAArray needs at least one field.");
+
+  // A bool column would be the bit-packed DynArray<bool>, which has no bool &
+  // to hand out through row() and get()
+  static_assert(!(std::is_same<Fields, bool>::value || ...), "SoAArray cannot hold bool fields; use unsigned char instead.");
+
+public:
+  static const std::size_t COLUMN_ALIGNMENT = 64;
+
+  template <std::size_t I>
+  using FieldType = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+  template <typename T>
+  using Column = DynArray<T, DoublingGrowth, Unchecked, COLUMN_ALIGNMENT>;
+
+  using value_type = std::tuple<Fields...>;
+  using reference = std::tuple<Fields &...>;
+  using const_reference = std::tuple<const Fields &...>;
+
+private:
+  std::tuple<Column<Fields>...> columns;
+  int rows;
+
+  using Indices = std::index_sequence_for<Fields...>;
+
+  void checkIndex(int) const;
+
+  // Appends one value per column; on failure the columns that already took
+  // their value are trimmed back so every column keeps the same length
+  template <typename Tuple, std::size_t... I>
+  void appendRow(Tuple &&, std::index_sequence<I...>);
+
+  template <std::size_t... I>
+  void removeRow(int, std::index_sequence<I...>);
+
+  template <std::size_t... I>
+  void reserveColumns(int, std::index_sequence<I...>);
+
+  template <std::size_t... I>
+  reference rowAt(int, std::index_sequence<I...>);
+
+  template <std::size_t... I>
+  const_reference rowAt(int, std::index_sequence<I...>) const;
+
+public:
+  SoAArray();
+
+  void append(const value_type &);
+  void append(value_type &&);
+  void append(const Fields &...);
+
+  // Removes the row at the given index from every column
+  void remove(int);
+  void replace(const value_type &, int);
+
+  // Grows every column to hold at least the given number of rows
+  void reserve(int);
+
+  value_type getItem(int) const;
+
+  // Proxy row: a tuple of references into the columns, so assigning a tuple
+  // to it writes the fields in place. The references last until the next
+  // append or remove.
+  reference row(int);
+  const_reference row(int) const;
+  reference operator[](int);
+  const_reference operator[](int) const;
+
+  // Single field of a row
+  template <std::size_t I>
+  FieldType<I> &get(int);
+
+  template <std::size_t I>
+  const FieldType<I> &get(int) const;
+
+  // Contiguous storage of one column
+  template <std::size_t I>
+  FieldType<I> *data();
+
+  template <std::size_t I>
+  const FieldType<I> *data() const;
+
+#if __cplusplus >= 202002L
+  template <std::size_t I>
+  std::span<FieldType<I>> column();
+
+  template <std::size_t I>
+  std::span<const FieldType<I>> column() const;
+#endif
+
+  bool isEmpty() const;
+  int countItems() const;
+  int size() const;
+};
+
+template <typename... Fields>
+SoAArray<Fields...>::SoAArray() : rows(0)
+{
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::checkIndex(int index) const
+{
+  if (index < 0 || index >= rows)
+  {
+    throw std::out_of_range("Index of array is out of range.");
+  }
+}
+
+template <typename... Fields>
+template <typename Tuple, std::size_t... I>
+void SoAArray<Fields...>::appendRow(Tuple &&row, std::index_sequence<I...>)
+{
+  std::size_t done = 0;
+
+  try
+  {
+    ((std::get<I>(columns).append(std::get<I>(std::forward<Tuple>(row))), done++), ...);
+  }
+  catch (...)
+  {
+    ((I < done ? std::get<I>(columns).remove(rows) : void()), ...);
+    throw;
+  }
+
+  rows++;
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void SoAArray<Fields...>::removeRow(int index, std::index_sequence<I...>)
+{
+  (std::get<I>(columns).remove(index), ...);
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void SoAArray<Fields...>::reserveColumns(int size, std::index_sequence<I...>)
+{
+  (std::get<I>(columns).reserve(size), ...);
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+typename SoAArray<Fields...>::reference SoAArray<Fields...>::rowAt(int index, std::index_sequence<I...>)
+{
+  return reference(std::get<I>(columns)[index]...);
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::rowAt(int index, std::index_sequence<I...>) const
+{
+  return const_reference(std::get<I>(columns)[index]...);
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::append(const value_type &row)
+{
+  appendRow(row, Indices());
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::append(value_type &&row)
+{
+  appendRow(std::move(row), Indices());
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::append(const Fields &...fields)
+{
+  appendRow(std::forward_as_tuple(fields...), Indices());
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::remove(int index)
+{
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
+
+  checkIndex(index);
+  removeRow(index, Indices());
+  rows--;
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::replace(const value_type &item, int index)
+{
+  row(index) = item;
+}
+
+template <typename... Fields>
+void SoAArray<Fields...>::reserve(int size)
+{
+  reserveColumns(size, Indices());
+}
+
+template <typename... Fields>
+typename SoAArray<Fields...>::value_type SoAArray<Fields...>::getItem(int index) const
+{
+  return value_type(row(index));
+}
+
+template <typename... Fields>
+typename SoAArray<Fields...>::reference SoAArray<Fields...>::row(int index)
+{
+  checkIndex(index);
+  return rowAt(index, Indices());
+}
+
+template <typename... Fields>
+typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::row(int index) const
+{
+  checkIndex(index);
+  return rowAt(index, Indices());
+}
+
+template <typename... Fields>
+typename SoAArray<Fields...>::reference SoAArray<Fields...>::operator[](int index)
+{
+  return row(index);
+}
+
+template <typename... Fields>
+typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::operator[](int index) const
+{
+  return row(index);
+}
+
+template <typename... Fields>
+template <std::size_t I>
+typename SoAArray<Fields...>::template FieldType<I> &SoAArray<Fields...>::get(int index)
+{
+  checkIndex(index);
+  return std::get<I>(columns)[index];
+}
+
+template <typename... Fields>
+template <std::size_t I>
+const typename SoAArray<Fields...>::template FieldType<I> &SoAArray<Fields...>::get(int index) const
+{
+  checkIndex(index);
+  return std::get<I>(columns)[index];
+}
+
+template <typename... Fields>
+template <std::size_t I>
+typename SoAArray<Fields...>::template FieldType<I> *SoAArray<Fields...>::data()
+{
+  return std::get<I>(columns).data();
+}
+
+template <typename... Fields>
+template <std::size_t I>
+const typename SoAArray<Fields...>::template FieldType<I> *SoAArray<Fields...>::data() const
+{
+  return std::get<I>(columns).data();
+}
+
+#if __cplusplus >= 202002L
+template <typename... Fields>
+template <std::size_t I>
+std::span<typename SoAArray<Fields...>::template FieldType<I>> SoAArray<Fields...>::column()
+{
+  return std::span<FieldType<I>>(data<I>(), rows);
+}
+
+template <typename... Fields>
+template <std::size_t I>
+std::span<const typename SoAArray<Fields...>::template FieldType<I>> SoAArray<Fields...>::column() const
+{
+  return std::span<const FieldType<I>>(data<I>(), rows);
+}
+#endif
+
+template <typename... Fields>
+bool SoAArray<Fields...>::isEmpty() const
+{
+  return rows == 0;
+}
+
+template <typename... Fields>
+int SoAArray<Fields...>::countItems() const
+{
+  return rows;
+}
+
+template <typename... Fields>
+int SoAArray<Fields...>::size() const
+{
+  return rows;
+}
+
+#endif
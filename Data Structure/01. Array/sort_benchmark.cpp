@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "dynamic_array.cpp"
+
+// Times DynArray::sort and DynArray::radixSort against single threaded
+// std::sort on random ints.
+// Usage: sort_benchmark [items]   (default 100 million)
+// Build: g++ -std=c++17 -O2 -pthread sort_benchmark.cpp -o sort_benchmark
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+  int n = argc > 1 ? std::atoi(argv[1]) : 100000000;
+  if (n < 1)
+  {
+    std::printf("Number of items must be 1 or more.\n");
+    return 1;
+  }
+
+  DynArray<int> source(n);
+  std::mt19937 rng(42);
+  for (int i = 0; i < n; i++)
+  {
+    source.append(static_cast<int>(rng()));
+  }
+
+  DynArray<int> items(source);
+  auto start = std::chrono::steady_clock::now();
+  std::sort(items.begin(), items.end());
+  double baseline = secondsSince(start);
+
+  std::printf("%d items, %u hardware threads\n", n, std::thread::hardware_concurrency());
+  std::printf("std::sort          %8.3f s\n", baseline);
+
+  items = source;
+  start = std::chrono::steady_clock::now();
+  items.radixSort();
+  double radixElapsed = secondsSince(start);
+
+  bool radixSorted = std::is_sorted(items.begin(), items.end());
+  std::printf("radixSort          %8.3f s   %5.2fx%s\n", radixElapsed, baseline / radixElapsed, radixSorted ? "" : "   NOT SORTED");
+
+  const int threadCounts[] = {1, 2, 4, 8, 16};
+  for (int threads : threadCounts)
+  {
+    items = source;
+    start = std::chrono::steady_clock::now();
+    items.sort(std::less<int>(), threads);
+    double elapsed = secondsSince(start);
+
+    bool sorted = std::is_sorted(items.begin(), items.end());
+    std::printf("sort, %2d threads   %8.3f s   %5.2fx%s\n", threads, elapsed, baseline / elapsed, sorted ? "" : "   NOT SORTED");
+  }
+
+  return 0;
+}
@@ -0,0 +1,361 @@
+#ifndef SORTED_ARRAY_CPP
+
+#define SORTED_ARRAY_CPP
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "dynamic_array.cpp"
+
+// Keys kept in ascending order in one contiguous DynArray, shared by the map
+// and set forms of SortedArray. Lookups are binary searches; indices handed
+// out stay valid until the next insert or remove.
+template <typename K, typename Compare>
+class SortedKeys
+{
+protected:
+  DynArray<K, DoublingGrowth, Unchecked> keys;
+  Compare comp;
+
+  bool isEqual(const K &, const K &) const;
+
+  // Indices of the batch items in key order, with duplicates dropped so that
+  // the last occurrence of a key wins (the same as inserting one by one)
+  DynArray<int> batchOrder(const K *, int) const;
+
+public:
+  SortedKeys() = default;
+  explicit SortedKeys(const Compare &compare) : comp(compare) {}
+
+  // Index of the given key, otherwise -1
+  int find(const K &) const;
+  bool contains(const K &) const;
+
+  // Index of the first key not less than / greater than the given one
+  int lower_bound(const K &) const;
+  int upper_bound(const K &) const;
+
+  // Half-open index range [first, second) of the keys within [low, high]
+  std::pair<int, int> range(const K &, const K &) const;
+  int countRange(const K &, const K &) const;
+
+  const K &keyAt(int) const;
+  int countItems() const;
+  bool isEmpty() const;
+};
+
+// Flat sorted map: keys and values live in two parallel DynArrays, so a
+// lookup only touches the (densely packed) keys. insertBatch() sorts the
+// incoming items and merges them in one pass instead of shifting the array
+// once per item. Use SortedArray<K> (V = void) for a sorted set.
+template <typename K, typename V = void, typename Compare = std::less<K>>
+class SortedArray : public SortedKeys<K, Compare>
+{
+private:
+  DynArray<V, DoublingGrowth, Unchecked> values;
+
+public:
+  SortedArray() = default;
+  explicit SortedArray(const Compare &compare) : SortedKeys<K, Compare>(compare) {}
+
+  // Inserts the pair or, if the key is present, replaces its value.
+  // Returns true if a new key was added.
+  bool insert(const K &, const V &);
+
+  // Inserts 'count' pairs with one sort of the batch and one merge pass
+  void insertBatch(const K *, const V *, int);
+
+  // Removes the key; returns false if it was not present
+  bool remove(const K &);
+
+  // Value of the given key, otherwise nullptr
+  V *findValue(const K &);
+  const V *findValue(const K &) const;
+
+  V &valueAt(int);
+  const V &valueAt(int) const;
+};
+
+// Flat sorted set
+template <typename K, typename Compare>
+class SortedArray<K, void, Compare> : public SortedKeys<K, Compare>
+{
+public:
+  SortedArray() = default;
+  explicit SortedArray(const Compare &compare) : SortedKeys<K, Compare>(compare) {}
+
+  // Returns true if the key was not present yet
+  bool insert(const K &);
+
+  // Inserts 'count' keys with one sort of the batch and one merge pass
+  void insertBatch(const K *, int);
+
+  // Removes the key; returns false if it was not present
+  bool remove(const K &);
+};
+
+template <typename K, typename Compare>
+bool SortedKeys<K, Compare>::isEqual(const K &a, const K &b) const
+{
+  return !comp(a, b) && !comp(b, a);
+}
+
+template <typename K, typename Compare>
+DynArray<int> SortedKeys<K, Compare>::batchOrder(const K *batch, int count) const
+{
+  DynArray<int> order(count);
+  for (int i = 0; i < count; i++)
+  {
+    order.append(i);
+  }
+
+  // Stable, so equal keys stay in input order and the last one can win
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                   { return comp(batch[a], batch[b]); });
+
+  auto isDuplicate = [&](int position)
+  {
+    return position + 1 < count && isEqual(batch[order[position]], batch[order[position + 1]]);
+  };
+
+  int kept = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (!isDuplicate(i))
+    {
+      order[kept++] = order[i];
+    }
+  }
+
+  order.removeRange(kept, count - kept);
+  return order;
+}
+
+template <typename K, typename Compare>
+int SortedKeys<K, Compare>::lower_bound(const K &key) const
+{
+  return static_cast<int>(std::lower_bound(keys.begin(), keys.end(), key, comp) - keys.begin());
+}
+
+template <typename K, typename Compare>
+int SortedKeys<K, Compare>::upper_bound(const K &key) const
+{
+  return static_cast<int>(std::upper_bound(keys.begin(), keys.end(), key, comp) - keys.begin());
+}
+
+template <typename K, typename Compare>
+int SortedKeys<K, Compare>::find(const K &key) const
+{
+  int index = lower_bound(key);
+
+  if (index < keys.countItems() && !comp(key, keys[index]))
+  {
+    return index;
+  }
+  return -1;
+}
+
+template <typename K, typename Compare>
+bool SortedKeys<K, Compare>::contains(const K &key) const
+{
+  return find(key) != -1;
+}
+
+template <typename K, typename Compare>
+std::pair<int, int> SortedKeys<K, Compare>::range(const K &low, const K &high) const
+{
+  int first = lower_bound(low);
+  int last = upper_bound(high);
+
+  return std::make_pair(first, last < first ? first : last);
+}
+
+template <typename K, typename Compare>
+int SortedKeys<K, Compare>::countRange(const K &low, const K &high) const
+{
+  std::pair<int, int> bounds = range(low, high);
+  return bounds.second - bounds.first;
+}
+
+template <typename K, typename Compare>
+const K &SortedKeys<K, Compare>::keyAt(int index) const
+{
+  return keys.at(index);
+}
+
+template <typename K, typename Compare>
+int SortedKeys<K, Compare>::countItems() const
+{
+  return keys.countItems();
+}
+
+template <typename K, typename Compare>
+bool SortedKeys<K, Compare>::isEmpty() const
+{
+  return keys.isEmpty();
+}
+
+template <typename K, typename V, typename Compare>
+bool SortedArray<K, V, Compare>::insert(const K &key, const V &value)
+{
+  int index = this->lower_bound(key);
+
+  if (index < this->keys.countItems() && !this->comp(key, this->keys[index]))
+  {
+    values[index] = value;
+    return false;
+  }
+
+  this->keys.insert(key, index);
+  try
+  {
+    values.insert(value, index);
+  }
+  catch (...)
+  {
+    this->keys.remove(index);
+    throw;
+  }
+  return true;
+}
+
+template <typename K, typename V, typename Compare>
+void SortedArray<K, V, Compare>::insertBatch(const K *batchKeys, const V *batchValues, int count)
+{
+  DynArray<int> order = this->batchOrder(batchKeys, count);
+  int size = this->keys.countItems();
+  int added = order.countItems();
+
+  DynArray<K, DoublingGrowth, Unchecked> mergedKeys(size + added);
+  DynArray<V, DoublingGrowth, Unchecked> mergedValues(size + added);
+
+  // Classic two-way merge; a batch key equal to an existing one replaces it.
+  // The existing items are copied, not moved, so a throwing comparison or
+  // copy leaves the map as it was.
+  int i = 0, j = 0;
+  while (i < size || j < added)
+  {
+    if (j == added || (i < size && this->comp(this->keys[i], batchKeys[order[j]])))
+    {
+      mergedKeys.append(this->keys[i]);
+      mergedValues.append(values[i]);
+      i++;
+      continue;
+    }
+
+    if (i < size && !this->comp(batchKeys[order[j]], this->keys[i]))
+    {
+      i++;
+    }
+
+    mergedKeys.append(batchKeys[order[j]]);
+    mergedValues.append(batchValues[order[j]]);
+    j++;
+  }
+
+  this->keys = std::move(mergedKeys);
+  values = std::move(mergedValues);
+}
+
+template <typename K, typename V, typename Compare>
+bool SortedArray<K, V, Compare>::remove(const K &key)
+{
+  int index = this->find(key);
+
+  if (index == -1)
+  {
+    return false;
+  }
+
+  this->keys.remove(index);
+  values.remove(index);
+  return true;
+}
+
+template <typename K, typename V, typename Compare>
+V *SortedArray<K, V, Compare>::findValue(const K &key)
+{
+  int index = this->find(key);
+  return index == -1 ? nullptr : &values[index];
+}
+
+template <typename K, typename V, typename Compare>
+const V *SortedArray<K, V, Compare>::findValue(const K &key) const
+{
+  int index = this->find(key);
+  return index == -1 ? nullptr : &values[index];
+}
+
+template <typename K, typename V, typename Compare>
+V &SortedArray<K, V, Compare>::valueAt(int index)
+{
+  return values.at(index);
+}
+
+template <typename K, typename V, typename Compare>
+const V &SortedArray<K, V, Compare>::valueAt(int index) const
+{
+  return values.at(index);
+}
+
+template <typename K, typename Compare>
+bool SortedArray<K, void, Compare>::insert(const K &key)
+{
+  int index = this->lower_bound(key);
+
+  if (index < this->keys.countItems() && !this->comp(key, this->keys[index]))
+  {
+    return false;
+  }
+
+  this->keys.insert(key, index);
+  return true;
+}
+
+template <typename K, typename Compare>
+void SortedArray<K, void, Compare>::insertBatch(const K *batchKeys, int count)
+{
+  DynArray<int> order = this->batchOrder(batchKeys, count);
+  int size = this->keys.countItems();
+  int added = order.countItems();
+
+  DynArray<K, DoublingGrowth, Unchecked> merged(size + added);
+
+  // Copies the existing keys, so a throwing comparison leaves the set as it was
+  int i = 0, j = 0;
+  while (i < size || j < added)
+  {
+    if (j == added || (i < size && this->comp(this->keys[i], batchKeys[order[j]])))
+    {
+      merged.append(this->keys[i]);
+      i++;
+      continue;
+    }
+
+    if (i < size && !this->comp(batchKeys[order[j]], this->keys[i]))
+    {
+      i++;
+    }
+
+    merged.append(batchKeys[order[j]]);
+    j++;
+  }
+
+  this->keys = std::move(merged);
+}
+
+template <typename K, typename Compare>
+bool SortedArray<K, void, Compare>::remove(const K &key)
+{
+  int index = this->find(key);
+
+  if (index == -1)
+  {
+    return false;
+  }
+
+  this->keys.remove(index);
+  return true;
+}
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef STATIC_ARRAY_CPP
+
+#define STATIC_ARRAY_CPP
+
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "custom_exception"
+#include "check_policy.hpp"
+#include "simd_kernels.hpp"
+
+// Fixed size array whose capacity is a compile time constant. The items live
+// inside the object, so there is no heap allocation and no pointer to follow,
+// and every operation can run in a constexpr context (e.g. to build lookup
+// tables at compile time). Range checks on constant indices fold away.
+template <typename T, int N, typename CheckPolicy = Checked>
+class StaticArray
+{
+  static_assert(N > 0, "Size of array must be 1 or more.");
+
+private:
+  T items[N]{};
+  int lastIndex = -1;
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  constexpr StaticArray() = default;
+  constexpr StaticArray(std::initializer_list<T>);
+
+  constexpr void append(const T &);
+  constexpr void insert(const T &, int);
+  constexpr void remove(int);
+  constexpr void replace(const T &, int);
+
+  constexpr T getItem(int) const;
+
+  // Reference access; operator[] follows CheckPolicy, at() always throws
+  constexpr T &operator[](int);
+  constexpr const T &operator[](int) const;
+  constexpr T &at(int);
+  constexpr const T &at(int) const;
+
+  constexpr int findIndex(const T &) const;
+  constexpr bool isFull() const;
+  constexpr bool isEmpty() const;
+  constexpr int countItems() const;
+  constexpr int getCapacity() const;
+  void display() const;
+
+  constexpr T *data();
+  constexpr const T *data() const;
+  constexpr int size() const;
+  constexpr iterator begin();
+  constexpr iterator end();
+  constexpr const_iterator begin() const;
+  constexpr const_iterator end() const;
+};
+
+template <typename T, int N, typename CheckPolicy>
+constexpr StaticArray<T, N, CheckPolicy>::StaticArray(std::initializer_list<T> list)
+{
+  for (const T &item : list)
+  {
+    append(item);
+  }
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr bool StaticArray<T, N, CheckPolicy>::isEmpty() const
+{
+  return lastIndex == -1;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr bool StaticArray<T, N, CheckPolicy>::isFull() const
+{
+  return lastIndex + 1 == N;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr void StaticArray<T, N, CheckPolicy>::append(const T &item)
+{
+  if (isFull())
+  {
+    throw ArrayOverflow("Cannot append an item because array is full!.");
+  }
+
+  lastIndex++;
+  items[lastIndex] = item;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr void StaticArray<T, N, CheckPolicy>::insert(const T &item, int index)
+{
+  if (isFull())
+  {
+    throw ArrayOverflow("Cannot insert an item because array is full!.");
+  }
+
+  if (index < 0 || index > lastIndex + 1)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  for (int i = lastIndex; i >= index; i--)
+  {
+    items[i + 1] = std::move(items[i]);
+  }
+
+  items[index] = item;
+  lastIndex++;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr void StaticArray<T, N, CheckPolicy>::remove(int index)
+{
+  if (isEmpty())
+  {
+    throw ArrayUnderflow("Cannot remove an item because array is empty.");
+  }
+
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  for (int i = index; i < lastIndex; i++)
+  {
+    items[i] = std::move(items[i + 1]);
+  }
+
+  lastIndex--;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr void StaticArray<T, N, CheckPolicy>::replace(const T &item, int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  items[index] = item;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr T StaticArray<T, N, CheckPolicy>::getItem(int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return items[index];
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr T &StaticArray<T, N, CheckPolicy>::operator[](int index)
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return items[index];
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr const T &StaticArray<T, N, CheckPolicy>::operator[](int index) const
+{
+  CheckPolicy::check(index >= 0 && index <= lastIndex, "Index is out of range.");
+
+  return items[index];
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr T &StaticArray<T, N, CheckPolicy>::at(int index)
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  return items[index];
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr const T &StaticArray<T, N, CheckPolicy>::at(int index) const
+{
+  if (index < 0 || index > lastIndex)
+  {
+    throw out_of_range("Index is out of range.");
+  }
+
+  return items[index];
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr int StaticArray<T, N, CheckPolicy>::findIndex(const T &item) const
+{
+#if __cpp_lib_is_constant_evaluated
+  // The SIMD kernels are only usable at run time
+  if constexpr (simd::IsSearchable<T>::value)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      return simd::findFirst(items, lastIndex + 1, item);
+    }
+  }
+#endif
+
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    if (items[i] == item)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr int StaticArray<T, N, CheckPolicy>::countItems() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr int StaticArray<T, N, CheckPolicy>::getCapacity() const
+{
+  return N;
+}
+
+template <typename T, int N, typename CheckPolicy>
+void StaticArray<T, N, CheckPolicy>::display() const
+{
+  std::cout << "[";
+  for (int i = 0; i <= lastIndex; i++)
+  {
+    std::cout << items[i] << (i == lastIndex ? "" : ", ");
+  }
+  std::cout << "]";
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr T *StaticArray<T, N, CheckPolicy>::data()
+{
+  return items;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr const T *StaticArray<T, N, CheckPolicy>::data() const
+{
+  return items;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr int StaticArray<T, N, CheckPolicy>::size() const
+{
+  return lastIndex + 1;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr typename StaticArray<T, N, CheckPolicy>::iterator StaticArray<T, N, CheckPolicy>::begin()
+{
+  return items;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr typename StaticArray<T, N, CheckPolicy>::iterator StaticArray<T, N, CheckPolicy>::end()
+{
+  return items + lastIndex + 1;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr typename StaticArray<T, N, CheckPolicy>::const_iterator StaticArray<T, N, CheckPolicy>::begin() const
+{
+  return items;
+}
+
+template <typename T, int N, typename CheckPolicy>
+constexpr typename StaticArray<T, N, CheckPolicy>::const_iterator StaticArray<T, N, CheckPolicy>::end() const
+{
+  return items + lastIndex + 1;
+}
+
+#endif
@@ -1,7 +1,8 @@
 #include <iostream>
 #include "custom_exception"
+#include "node_allocator.hpp"
 
-template <typename T>
+template <typename T, template <typename> class NodeAllocator = SlabAllocator>
 class CDLL
 {
 private:
@@ -11,13 +12,19 @@ private:
     T data;
     Node *next;
 
+    // The list the node belongs to, so a node pointer is checked in O(1)
+    const CDLL *owner;
+
     // Constructor
-    Node(const T &value) : data(value), prev(nullptr), next(nullptr) {};
+    Node(const T &value, const CDLL *list) : prev(nullptr), data(value), next(nullptr), owner(list) {};
   };
 
   Node *tail;
   std::size_t size;
 
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
 protected:
   // Releases the memory of the list
   void clear();
@@ -25,7 +32,9 @@ protected:
   // copies the data from the specified list
   void copy(const CDLL &);
 
-  // Check if node is exists in the list or not
+  // Check if node is exists in the list or not. O(1): compares the node's
+  // owner tag with this list. A pointer to a removed node is invalid and
+  // not detected, since its memory may already hold another node.
   bool isNodeExist(const Node *) const;
 
 public:
@@ -34,13 +43,18 @@ public:
   CDLL(const CDLL &);
   CDLL &operator=(const CDLL &);
   
-  template <typename U>
-  friend std::ostream &operator<<(std::ostream &, const CDLL<U> &);
+  template <typename U, template <typename> class A>
+  friend std::ostream &operator<<(std::ostream &, const CDLL<U, A> &);
 
   void insertFront(const T &);
   void insertBack(const T &);
   void insertAfter(const T &, Node *);
   void insertBefore(const T &, Node *);
+
+  // Same as above without checking that the node belongs to the list
+  void insertAfter(const T &, Node *, UncheckedNode);
+  void insertBefore(const T &, Node *, UncheckedNode);
+
   void insert(const T &, const int);
 
   void removeFront();
@@ -48,6 +62,7 @@ public:
 
   // Deletes node from list if exists; otherwise it will throw an NodeNotFound exception.
   void removeNode(const Node *);
+  void removeNode(const Node *, UncheckedNode);
 
   // Removes the first occurrence of specified data from the list if second argument is false; otherwise delete all the data from list.
   void remove(const T &, const bool = true);
@@ -59,13 +74,13 @@ public:
 
   // It is used to print list using standard output stream (cout).
   template <typename U>
-  friend std::ostream &operator<<(std::ostream &, const CDLL<T> &);
+  friend std::ostream &operator<<(std::ostream &, const CDLL<T, NodeAllocator> &);
 };
 
-template <typename T>
-void CDLL<T>::insertFront(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertFront(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
 
   if (isEmpty())
   {
@@ -84,10 +99,10 @@ void CDLL<T>::insertFront(const T &value)
   size++;
 }
 
-template <typename T>
-void CDLL<T>::insertBack(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertBack(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
 
   if (isEmpty())
   {
@@ -108,8 +123,8 @@ void CDLL<T>::insertBack(const T &value)
   size++;
 }
 
-template <typename T>
-void CDLL<T>::insertAfter(const T &value, Node *node)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertAfter(const T &value, Node *node)
 {
   if (node == nullptr)
   {
@@ -121,13 +136,19 @@ void CDLL<T>::insertAfter(const T &value, Node *node)
     throw NodeNotFound("Node not exist in the list.");
   }
 
+  insertAfter(value, node, UNCHECKED_NODE);
+}
+
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertAfter(const T &value, Node *node, UncheckedNode)
+{
   if (node == tail)
   {
     insertBack(value);
     return;
   }
 
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
   newNode->prev = node;
   newNode->next = node->next;
   node->next->prev = newNode;
@@ -136,8 +157,8 @@ void CDLL<T>::insertAfter(const T &value, Node *node)
   size++;
 }
 
-template <typename T>
-void CDLL<T>::insertBefore(const T &value, Node *node)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertBefore(const T &value, Node *node)
 {
   if (node == nullptr)
   {
@@ -149,13 +170,19 @@ void CDLL<T>::insertBefore(const T &value, Node *node)
     throw NodeNotFound("Node not exist in the list.");
   }
 
+  insertBefore(value, node, UNCHECKED_NODE);
+}
+
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insertBefore(const T &value, Node *node, UncheckedNode)
+{
   if (tail->next == node)
   {
     insertFront(value);
     return;
   }
 
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
   newNode->prev = node->prev;
   newNode->next = node;
   node->prev->next = newNode;
@@ -164,8 +191,8 @@ void CDLL<T>::insertBefore(const T &value, Node *node)
   size++;
 }
 
-template <typename T>
-void CDLL<T>::insert(const T &value, const int index)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::insert(const T &value, const int index)
 {
   if (index < 0 || index > size)
   {
@@ -185,11 +212,11 @@ void CDLL<T>::insert(const T &value, const int index)
     currentNode = currentNode->next;
   }
 
-  insertAfter(value, currentNode);
+  insertAfter(value, currentNode, UNCHECKED_NODE);
 }
 
-template <typename T>
-void CDLL<T>::removeFront()
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::removeFront()
 {
   if (isEmpty())
   {
@@ -198,21 +225,21 @@ void CDLL<T>::removeFront()
 
   if (size == 1)
   {
-    delete tail;
+    nodes.destroy(tail);
     tail = nullptr;
   }
   else
   {
     tail->next = tail->next->next;
-    delete tail->next->prev;
+    nodes.destroy(tail->next->prev);
     tail->next->prev = tail;
   }
 
   size--;
 }
 
-template <typename T>
-void CDLL<T>::removeBack()
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::removeBack()
 {
   if (isEmpty())
   {
@@ -221,28 +248,34 @@ void CDLL<T>::removeBack()
 
   if (size == 1)
   {
-    delete tail;
+    nodes.destroy(tail);
     tail = nullptr;
   }
   else
   {
     tail->prev->next = tail->next;
     tail = tail->prev;
-    delete tail->next->prev;
+    nodes.destroy(tail->next->prev);
     tail->next->prev = tail;
   }
 
   size--;
 }
 
-template <typename T>
-void CDLL<T>::removeNode(const Node *node)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::removeNode(const Node *node)
 {
   if (!isNodeExist(node))
   {
     throw NodeNotFound("Node not exist in the list.");
   }
 
+  removeNode(node, UNCHECKED_NODE);
+}
+
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::removeNode(const Node *node, UncheckedNode)
+{
   if (tail->next == node)
   {
     removeFront();
@@ -257,43 +290,42 @@ void CDLL<T>::removeNode(const Node *node)
 
   node->prev->next = node->next;
   node->next->prev = node->prev;
-  delete node;
+  nodes.destroy(const_cast<Node *>(node));
 
   size--;
 }
 
-template <typename T>
-void CDLL<T>::remove(const T &value, const bool isRemoveAll)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::remove(const T &value, const bool isRemoveAll)
 {
   if (!isEmpty())
   {
-    int count = 0;
+    // Visits every node of the list as it was, since size shrinks with each
+    // removal
+    std::size_t nodesLeft = size;
     Node *currentNode = tail->next;
 
-    do
+    while (nodesLeft-- > 0)
     {
-      count++;
+      Node *nextNode = currentNode->next;
+
       if (currentNode->data == value)
       {
-        Node *deleteNode = currentNode;
-        currentNode = currentNode->next;
-        removeNode(deleteNode);
+        removeNode(currentNode, UNCHECKED_NODE);
 
         if (isRemoveAll == false)
         {
           return;
         }
-
-        continue;
       }
 
-      currentNode = currentNode->next;
-    } while (count < size);
+      currentNode = nextNode;
+    }
   }
 }
 
-template <typename T>
-typename CDLL<T>::Node *CDLL<T>::search(const T &value) const
+template <typename T, template <typename> class NodeAllocator>
+typename CDLL<T, NodeAllocator>::Node *CDLL<T, NodeAllocator>::search(const T &value) const
 {
   if (!isEmpty())
   {
@@ -312,48 +344,43 @@ typename CDLL<T>::Node *CDLL<T>::search(const T &value) const
   return nullptr;
 }
 
-template <typename T>
-std::size_t CDLL<T>::getSize() const
+template <typename T, template <typename> class NodeAllocator>
+std::size_t CDLL<T, NodeAllocator>::getSize() const
 {
   return size;
 }
 
-template <typename T>
-bool CDLL<T>::isEmpty() const
+template <typename T, template <typename> class NodeAllocator>
+bool CDLL<T, NodeAllocator>::isEmpty() const
 {
   return size == 0;
 }
 
-template <typename T>
-bool CDLL<T>::isNodeExist(const Node *node) const
+template <typename T, template <typename> class NodeAllocator>
+bool CDLL<T, NodeAllocator>::isNodeExist(const Node *node) const
 {
-  if (!isEmpty())
-  {
-    Node *currentNode = tail;
-    do
-    {
-      if (currentNode == node)
-      {
-        return true;
-      }
-      currentNode = currentNode->next;
-    } while (currentNode != tail);
-  }
-
-  return false;
+  return node != nullptr && node->owner == this;
 }
 
-template <typename T>
-void CDLL<T>::clear()
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::clear()
 {
-  while (tail)
+  // Break the circle so the allocator sees a chain ending in nullptr, then
+  // free every node at once
+  Node *first = nullptr;
+  if (tail != nullptr)
   {
-    removeFront();
+    first = tail->next;
+    tail->next = nullptr;
   }
+
+  nodes.destroyList(first);
+  tail = nullptr;
+  size = 0;
 }
 
-template <typename T>
-void CDLL<T>::copy(const CDLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+void CDLL<T, NodeAllocator>::copy(const CDLL &obj)
 {
   if (this != &obj)
   {
@@ -370,28 +397,28 @@ void CDLL<T>::copy(const CDLL &obj)
   }
 }
 
-template <typename T>
-CDLL<T>::~CDLL()
+template <typename T, template <typename> class NodeAllocator>
+CDLL<T, NodeAllocator>::~CDLL()
 {
   clear();
 }
 
-template <typename T>
-CDLL<T>::CDLL(const CDLL &obj) : size(0), tail(nullptr)
+template <typename T, template <typename> class NodeAllocator>
+CDLL<T, NodeAllocator>::CDLL(const CDLL &obj) : size(0), tail(nullptr)
 {
   copy(obj);
 }
 
-template <typename T>
-CDLL<T> &CDLL<T>::operator=(const CDLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+CDLL<T, NodeAllocator> &CDLL<T, NodeAllocator>::operator=(const CDLL &obj)
 {
   copy(obj);
   return *this;
 }
 
 // Definition of friend function
-template <typename T>
-std::ostream &operator<<(std::ostream &dout, const CDLL<T> &obj)
+template <typename T, template <typename> class NodeAllocator>
+std::ostream &operator<<(std::ostream &dout, const CDLL<T, NodeAllocator> &obj)
 {
   if (obj.isEmpty())
   {
@@ -400,7 +427,7 @@ std::ostream &operator<<(std::ostream &dout, const CDLL<T> &obj)
   else
   {
 
-    typename CDLL<T>::Node *currentNode = obj.tail->next;
+    typename CDLL<T, NodeAllocator>::Node *currentNode = obj.tail->next;
 
     do
     {
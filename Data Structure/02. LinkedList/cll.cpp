@@ -1,7 +1,8 @@
 #include <iostream>
 #include "custom_exception"
+#include "node_allocator.hpp"
 
-template <typename T>
+template <typename T, template <typename> class NodeAllocator = SlabAllocator>
 class CLL
 {
 private:
@@ -15,6 +16,9 @@ private:
   Node *tail;
   int size;
 
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
 protected:
   void clear();
   void copy(const CLL &);
@@ -24,8 +28,8 @@ public:
   ~CLL();
   CLL(const CLL &);
   CLL &operator=(const CLL &);
-  template <typename U>
-  friend std::ostream &operator<<(std::ostream &, const CLL<U> &);
+  template <typename U, template <typename> class A>
+  friend std::ostream &operator<<(std::ostream &, const CLL<U, A> &);
 
 
   inline void insertFront(const T &);
@@ -40,27 +44,27 @@ public:
   inline bool isEmpty() const;
 };
 
-template <typename T>
-CLL<T>::~CLL()
+template <typename T, template <typename> class NodeAllocator>
+CLL<T, NodeAllocator>::~CLL()
 {
   clear();
 }
 
-template <typename T>
-CLL<T>::CLL(const CLL &obj) : tail(nullptr), size(0)
+template <typename T, template <typename> class NodeAllocator>
+CLL<T, NodeAllocator>::CLL(const CLL &obj) : tail(nullptr), size(0)
 {
   copy(obj);
 }
 
-template <typename T>
-CLL<T> &CLL<T>::operator=(const CLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+CLL<T, NodeAllocator> &CLL<T, NodeAllocator>::operator=(const CLL &obj)
 {
   copy(obj);
   return *this;
 }
 
-template <typename T>
-std::ostream &operator<<(std::ostream &dout, const CLL<T> &obj)
+template <typename T, template <typename> class NodeAllocator>
+std::ostream &operator<<(std::ostream &dout, const CLL<T, NodeAllocator> &obj)
 {
   if (obj.isEmpty())
   {
@@ -68,7 +72,7 @@ std::ostream &operator<<(std::ostream &dout, const CLL<T> &obj)
   }
   else
   {
-    typename CLL<T>::Node *currentNode = obj.tail->next;
+    typename CLL<T, NodeAllocator>::Node *currentNode = obj.tail->next;
 
     do
     {
@@ -83,8 +87,8 @@ std::ostream &operator<<(std::ostream &dout, const CLL<T> &obj)
   return dout;
 }
 
-template <typename T>
-void CLL<T>::copy(const CLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::copy(const CLL &obj)
 {
   if (this != &obj)
   {
@@ -102,19 +106,27 @@ void CLL<T>::copy(const CLL &obj)
   }
 }
 
-template <typename T>
-void CLL<T>::clear()
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::clear()
 {
-  while (tail)
+  // Break the circle so the allocator sees a chain ending in nullptr, then
+  // free every node at once
+  Node *first = nullptr;
+  if (tail != nullptr)
   {
-    removeFront();
+    first = tail->next;
+    tail->next = nullptr;
   }
+
+  nodes.destroyList(first);
+  tail = nullptr;
+  size = 0;
 }
 
-template <typename T>
-void CLL<T>::insertFront(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::insertFront(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
 
   if (isEmpty())
   {
@@ -129,10 +141,10 @@ void CLL<T>::insertFront(const T &value)
   size++;
 }
 
-template <typename T>
-void CLL<T>::insertBack(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::insertBack(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
 
   if (isEmpty())
   {
@@ -148,8 +160,8 @@ void CLL<T>::insertBack(const T &value)
   size++;
 }
 
-template <typename T>
-void CLL<T>::insert(const T &value, const int &pos)
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::insert(const T &value, const int &pos)
 {
 
   if (pos < 0 || pos > size)
@@ -169,7 +181,7 @@ void CLL<T>::insert(const T &value, const int &pos)
     return;
   }
 
-  Node *newNode = new Node(value), *currentNode = tail;
+  Node *newNode = nodes.create(value), *currentNode = tail;
   for (int i = 0; i < pos; i++)
   {
     currentNode = currentNode->next;
@@ -180,8 +192,8 @@ void CLL<T>::insert(const T &value, const int &pos)
   size++;
 }
 
-template <typename T>
-void CLL<T>::removeFront()
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::removeFront()
 {
   if (isEmpty())
   {
@@ -190,7 +202,7 @@ void CLL<T>::removeFront()
 
   if (tail == tail->next)
   {
-    delete tail;
+    nodes.destroy(tail);
     tail = nullptr;
     size--;
     return;
@@ -198,12 +210,12 @@ void CLL<T>::removeFront()
 
   Node *temp = tail->next;
   tail->next = tail->next->next;
-  delete temp;
+  nodes.destroy(temp);
   size--;
 }
 
-template <typename T>
-void CLL<T>::removeBack()
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::removeBack()
 {
   if (isEmpty())
   {
@@ -212,7 +224,7 @@ void CLL<T>::removeBack()
 
   if (tail == tail->next)
   {
-    delete tail;
+    nodes.destroy(tail);
     tail = nullptr;
     size--;
     return;
@@ -226,13 +238,13 @@ void CLL<T>::removeBack()
   }
 
   currentNode->next = currentNode->next->next;
-  delete tail;
+  nodes.destroy(tail);
   tail = currentNode;
   size--;
 }
 
-template <typename T>
-void CLL<T>::remove(const T &value, const bool isRemoveAll)
+template <typename T, template <typename> class NodeAllocator>
+void CLL<T, NodeAllocator>::remove(const T &value, const bool isRemoveAll)
 {
   Node *currentNode = nullptr;
 
@@ -248,7 +260,7 @@ void CLL<T>::remove(const T &value, const bool isRemoveAll)
         // if only one element is present
         if (tail->next == tail)
         {
-          delete tail;
+          nodes.destroy(tail);
           tail = nullptr;
           return;
         }
@@ -257,7 +269,7 @@ void CLL<T>::remove(const T &value, const bool isRemoveAll)
         Node *temp = currentNode->next;
         currentNode->next = currentNode->next->next;
 
-        delete temp;
+        nodes.destroy(temp);
         if (temp == tail)
         {
           tail = currentNode;
@@ -293,14 +305,14 @@ void CLL<T>::remove(const T &value, const bool isRemoveAll)
   }
 }
 
-template <typename T>
-int CLL<T>::getSize() const
+template <typename T, template <typename> class NodeAllocator>
+int CLL<T, NodeAllocator>::getSize() const
 {
   return size;
 }
 
-template <typename T>
-bool CLL<T>::isEmpty() const
+template <typename T, template <typename> class NodeAllocator>
+bool CLL<T, NodeAllocator>::isEmpty() const
 {
   return size == 0;
 }
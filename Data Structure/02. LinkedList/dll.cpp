@@ -1,8 +1,9 @@
 // Doubly Linked List
 #include <iostream>
 #include "custom_exception"
+#include "node_allocator.hpp"
 
-template <typename T>
+template <typename T, template <typename> class NodeAllocator = SlabAllocator>
 class DLL
 {
 private:
@@ -19,6 +20,9 @@ private:
   Node *head;
   Node *tail;
 
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
 protected:
   void clear();
   Node *search(const T &) const;
@@ -42,7 +46,7 @@ public:
 
   friend std::ostream &operator<<(std::ostream &dout, const DLL &obj)
   {
-    DLL<T>::Node *currentNode = obj.head;
+    DLL<T, NodeAllocator>::Node *currentNode = obj.head;
     while (currentNode)
     {
       dout << currentNode->data;
@@ -63,30 +67,30 @@ public:
   }
 };
 
-template <typename T>
-DLL<T>::~DLL()
+template <typename T, template <typename> class NodeAllocator>
+DLL<T, NodeAllocator>::~DLL()
 {
   clear();
 }
 
-template <typename T>
-DLL<T>::DLL(const DLL &obj) : size(0), head(nullptr), tail(nullptr)
+template <typename T, template <typename> class NodeAllocator>
+DLL<T, NodeAllocator>::DLL(const DLL &obj) : size(0), head(nullptr), tail(nullptr)
 {
   copy(obj);
 }
 
-template <typename T>
-DLL<T> &DLL<T>::operator=(const DLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+DLL<T, NodeAllocator> &DLL<T, NodeAllocator>::operator=(const DLL &obj)
 {
   copy(obj);
 
   return *this;
 }
 
-template <typename T>
-void DLL<T>::insertFront(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::insertFront(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
 
   if (isEmpty())
   {
@@ -102,10 +106,10 @@ void DLL<T>::insertFront(const T &value)
   size++;
 }
 
-template <typename T>
-void DLL<T>::insertBack(const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::insertBack(const T &value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
 
   if (isEmpty())
   {
@@ -121,8 +125,8 @@ void DLL<T>::insertBack(const T &value)
   size++;
 }
 
-template <typename T>
-void DLL<T>::insertAfter(const T &prevValue, const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::insertAfter(const T &prevValue, const T &value)
 {
   Node *prevNode = search(prevValue);
 
@@ -131,7 +135,7 @@ void DLL<T>::insertAfter(const T &prevValue, const T &value)
     throw NodeNotFound("Node not found of given data!");
   }
 
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
   newNode->prev = prevNode;
   newNode->next = prevNode->next;
   prevNode->next = newNode;
@@ -148,8 +152,8 @@ void DLL<T>::insertAfter(const T &prevValue, const T &value)
   size++;
 }
 
-template <typename T>
-void DLL<T>::insertBefore(const T &afterValue, const T &value)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::insertBefore(const T &afterValue, const T &value)
 {
   Node *afterNode = search(afterValue);
   if (afterNode == nullptr)
@@ -157,7 +161,7 @@ void DLL<T>::insertBefore(const T &afterValue, const T &value)
     throw NodeNotFound("Node not found of given data!");
   }
 
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value);
   newNode->next = afterNode;
   newNode->prev = afterNode->prev;
 
@@ -175,8 +179,8 @@ void DLL<T>::insertBefore(const T &afterValue, const T &value)
   size++;
 }
 
-template <typename T>
-void DLL<T>::removeFront()
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::removeFront()
 {
   if (isEmpty())
   {
@@ -185,20 +189,20 @@ void DLL<T>::removeFront()
 
   if (head == tail)
   {
-    delete head;
+    nodes.destroy(head);
     head = tail = nullptr;
   }
   else
   {
     head = head->next;
-    delete head->prev;
+    nodes.destroy(head->prev);
     head->prev = nullptr;
   }
   size--;
 }
 
-template <typename T>
-void DLL<T>::removeBack()
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::removeBack()
 {
   if (isEmpty())
   {
@@ -207,21 +211,21 @@ void DLL<T>::removeBack()
 
   if (head == tail)
   {
-    delete head;
+    nodes.destroy(head);
     head = tail = nullptr;
   }
   else
   {
     tail = tail->prev;
-    delete tail->next;
+    nodes.destroy(tail->next);
     tail->next = nullptr;
   }
 
   size--;
 }
 
-template <typename T>
-void DLL<T>::remove(const T &value, bool isALL)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::remove(const T &value, bool isALL)
 {
   Node *currentNode = head, *temp = nullptr;
   while (currentNode)
@@ -241,7 +245,7 @@ void DLL<T>::remove(const T &value, bool isALL)
       {
         currentNode->prev->next = currentNode->next;
         currentNode->next->prev = currentNode->prev;
-        delete currentNode;
+        nodes.destroy(currentNode);
         size--;
       }
 
@@ -255,20 +259,20 @@ void DLL<T>::remove(const T &value, bool isALL)
   }
 }
 
-template <typename T>
-bool DLL<T>::isEmpty() const
+template <typename T, template <typename> class NodeAllocator>
+bool DLL<T, NodeAllocator>::isEmpty() const
 {
   return size == 0;
 }
 
-template <typename T>
-int DLL<T>::getSize() const
+template <typename T, template <typename> class NodeAllocator>
+int DLL<T, NodeAllocator>::getSize() const
 {
   return size;
 }
 
-template <typename T>
-typename DLL<T>::Node *DLL<T>::search(const T &value) const
+template <typename T, template <typename> class NodeAllocator>
+typename DLL<T, NodeAllocator>::Node *DLL<T, NodeAllocator>::search(const T &value) const
 {
   Node *targetNode = head;
   while (targetNode)
@@ -284,19 +288,17 @@ typename DLL<T>::Node *DLL<T>::search(const T &value) const
   return nullptr;
 }
 
-template <typename T>
-void DLL<T>::clear()
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::clear()
 {
-  while (head)
-  {
-    removeFront();
-  }
-
+  // Frees every node at once instead of one removeFront() at a time
+  nodes.destroyList(head);
+  head = tail = nullptr;
   size = 0;
 }
 
-template <typename T>
-void DLL<T>::copy(const DLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+void DLL<T, NodeAllocator>::copy(const DLL &obj)
 {
   if (this != &obj)
   {
@@ -0,0 +1,535 @@
+// Hash Indexed Doubly Linked List
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include "custom_exception"
+#include "node_allocator.hpp"
+
+// A doubly linked list with a hash index from every value to its nodes, so
+// search, insertAfter/insertBefore by value and remove by value take
+// expected O(1) time instead of a scan, while the list keeps its order.
+//
+// The nodes holding the same value are chained to each other in list order,
+// and the index keeps the first and last node of each chain. To keep that
+// order without walking the list, every node carries an order label that
+// grows from head to tail. A label between two neighbours is their
+// midpoint; when two neighbours have no gap left, the nodes of the smallest
+// aligned label range around them that is sparse enough get evenly spread
+// labels. Only duplicated values inserted in the middle of their chain ever
+// walk it, so a list of distinct values (an ordered set) never does.
+template <typename T, typename Hash = std::hash<T>, template <typename> class NodeAllocator = SlabAllocator>
+class IndexedDLL
+{
+private:
+  struct Node
+  {
+    Node *prev;
+    T data;
+    Node *next;
+
+    // Neighbours holding the same value
+    Node *prevSame;
+    Node *nextSame;
+
+    std::uint64_t label;
+
+    Node(const T &data) : prev(nullptr), data(data), next(nullptr), prevSame(nullptr), nextSame(nullptr), label(0) {}
+  };
+
+  struct Chain
+  {
+    Node *first;
+    Node *last;
+    int count;
+  };
+
+  // Labels start in the middle of the range, this far apart
+  static const std::uint64_t LABEL_GAP = std::uint64_t(1) << 32;
+  static const std::uint64_t LABEL_START = std::uint64_t(1) << 63;
+
+  int size;
+  Node *head;
+  Node *tail;
+
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
+  std::unordered_map<T, Chain, Hash> index;
+
+  // Spreads the labels evenly over the range again
+  void relabel();
+
+  // Makes room for the label of a linked node by relabelling the nodes
+  // around it
+  void relabel(Node *);
+
+  // Gives a linked node a label between its neighbours
+  void assignLabel(Node *);
+
+  // Links a new node after 'prevNode' (at the front for nullptr) and adds
+  // it to the index
+  void link(Node *, Node *);
+
+  // Removes a node from the list and its chain and frees it
+  void unlink(Node *);
+
+protected:
+  void clear();
+  Node *search(const T &) const;
+  void copy(const IndexedDLL &);
+
+public:
+  IndexedDLL() : size(0), head(nullptr), tail(nullptr) {}
+  ~IndexedDLL();
+  IndexedDLL(const IndexedDLL &);
+  IndexedDLL &operator=(const IndexedDLL &);
+
+  void insertFront(const T &);
+  void insertBack(const T &);
+  // Inserts the value after / before the first occurrence of the first argument
+  void insertAfter(const T &, const T &);
+  void insertBefore(const T &, const T &);
+  void removeFront();
+  void removeBack();
+  // Removes the first occurrence of the value if 'false' is passed; removes all occurrences if 'true' is passed.
+  void remove(const T &, bool = true);
+  bool contains(const T &) const;
+  // Number of nodes holding the value
+  int count(const T &) const;
+  bool isEmpty() const;
+  int getSize() const;
+
+  friend std::ostream &operator<<(std::ostream &dout, const IndexedDLL &obj)
+  {
+    for (const Node *currentNode = obj.head; currentNode; currentNode = currentNode->next)
+    {
+      dout << currentNode->data;
+      if (currentNode != obj.tail)
+      {
+        dout << " <--> ";
+      }
+    }
+
+    if (obj.isEmpty())
+    {
+      dout << "List is empty!";
+    }
+
+    return dout;
+  }
+};
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+IndexedDLL<T, Hash, NodeAllocator>::~IndexedDLL()
+{
+  clear();
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+IndexedDLL<T, Hash, NodeAllocator>::IndexedDLL(const IndexedDLL &obj) : size(0), head(nullptr), tail(nullptr)
+{
+  copy(obj);
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+IndexedDLL<T, Hash, NodeAllocator> &IndexedDLL<T, Hash, NodeAllocator>::operator=(const IndexedDLL &obj)
+{
+  copy(obj);
+
+  return *this;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::relabel()
+{
+  std::uint64_t label = LABEL_START - static_cast<std::uint64_t>(size / 2) * LABEL_GAP;
+
+  for (Node *currentNode = head; currentNode; currentNode = currentNode->next)
+  {
+    currentNode->label = label;
+    label += LABEL_GAP;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::relabel(Node *node)
+{
+  std::uint64_t anchor = node->prev != nullptr ? node->prev->label : node->next->label;
+  Node *first = node;
+  Node *last = node;
+  std::uint64_t count = 1;
+
+  // Doubles an aligned range of labels around the node until it holds at
+  // most sqrt(width) nodes; the allowed density falls as the range grows,
+  // so repeated inserts at one spot relabel a larger range ever more rarely
+  for (int bits = 1; bits < 64; bits++)
+  {
+    std::uint64_t width = std::uint64_t(1) << bits;
+    std::uint64_t base = anchor & ~(width - 1);
+
+    while (first->prev != nullptr && first->prev->label >= base)
+    {
+      first = first->prev;
+      count++;
+    }
+
+    while (last->next != nullptr && last->next->label - base < width)
+    {
+      last = last->next;
+      count++;
+    }
+
+    if (count * count <= width)
+    {
+      std::uint64_t gap = width / count;
+      std::uint64_t label = base;
+
+      for (Node *currentNode = first; currentNode != last->next; currentNode = currentNode->next)
+      {
+        currentNode->label = label;
+        label += gap;
+      }
+      return;
+    }
+  }
+
+  relabel();
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::assignLabel(Node *node)
+{
+  Node *before = node->prev;
+  Node *after = node->next;
+
+  if (before == nullptr && after == nullptr)
+  {
+    node->label = LABEL_START;
+    return;
+  }
+
+  if (before == nullptr)
+  {
+    if (after->label >= LABEL_GAP)
+    {
+      node->label = after->label - LABEL_GAP;
+      return;
+    }
+  }
+  else if (after == nullptr)
+  {
+    if (before->label <= ~std::uint64_t(0) - LABEL_GAP)
+    {
+      node->label = before->label + LABEL_GAP;
+      return;
+    }
+  }
+  else if (after->label - before->label >= 2)
+  {
+    node->label = before->label + (after->label - before->label) / 2;
+    return;
+  }
+
+  // No room left at this spot; the node is linked already, so relabelling
+  // its neighbourhood covers it too
+  relabel(node);
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::link(Node *newNode, Node *prevNode)
+{
+  // The only step that may throw, done before anything is linked
+  auto entry = index.try_emplace(newNode->data, Chain{nullptr, nullptr, 0}).first;
+  Chain &chain = entry->second;
+
+  newNode->prev = prevNode;
+  newNode->next = prevNode == nullptr ? head : prevNode->next;
+
+  if (newNode->next == nullptr)
+  {
+    tail = newNode;
+  }
+  else
+  {
+    newNode->next->prev = newNode;
+  }
+
+  if (prevNode == nullptr)
+  {
+    head = newNode;
+  }
+  else
+  {
+    prevNode->next = newNode;
+  }
+
+  size++;
+  assignLabel(newNode);
+
+  // Find the node's place in its chain, walking back from the last one;
+  // distinct values and inserts at either end of the chain stop right away
+  Node *sameBefore = chain.last;
+  if (chain.first != nullptr && newNode->label < chain.first->label)
+  {
+    sameBefore = nullptr;
+  }
+
+  while (sameBefore != nullptr && sameBefore->label > newNode->label)
+  {
+    sameBefore = sameBefore->prevSame;
+  }
+
+  newNode->prevSame = sameBefore;
+  newNode->nextSame = sameBefore == nullptr ? chain.first : sameBefore->nextSame;
+
+  if (newNode->nextSame == nullptr)
+  {
+    chain.last = newNode;
+  }
+  else
+  {
+    newNode->nextSame->prevSame = newNode;
+  }
+
+  if (sameBefore == nullptr)
+  {
+    chain.first = newNode;
+  }
+  else
+  {
+    sameBefore->nextSame = newNode;
+  }
+
+  chain.count++;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::unlink(Node *node)
+{
+  auto entry = index.find(node->data);
+  Chain &chain = entry->second;
+
+  if (--chain.count == 0)
+  {
+    index.erase(entry);
+  }
+  else
+  {
+    if (node->prevSame == nullptr)
+    {
+      chain.first = node->nextSame;
+    }
+    else
+    {
+      node->prevSame->nextSame = node->nextSame;
+    }
+
+    if (node->nextSame == nullptr)
+    {
+      chain.last = node->prevSame;
+    }
+    else
+    {
+      node->nextSame->prevSame = node->prevSame;
+    }
+  }
+
+  if (node->prev == nullptr)
+  {
+    head = node->next;
+  }
+  else
+  {
+    node->prev->next = node->next;
+  }
+
+  if (node->next == nullptr)
+  {
+    tail = node->prev;
+  }
+  else
+  {
+    node->next->prev = node->prev;
+  }
+
+  nodes.destroy(node);
+  size--;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::insertFront(const T &value)
+{
+  Node *newNode = nodes.create(value);
+
+  try
+  {
+    link(newNode, nullptr);
+  }
+  catch (...)
+  {
+    nodes.destroy(newNode);
+    throw;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::insertBack(const T &value)
+{
+  Node *newNode = nodes.create(value);
+
+  try
+  {
+    link(newNode, tail);
+  }
+  catch (...)
+  {
+    nodes.destroy(newNode);
+    throw;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::insertAfter(const T &prevValue, const T &value)
+{
+  Node *prevNode = search(prevValue);
+
+  if (prevNode == nullptr)
+  {
+    throw NodeNotFound("Node not found of given data!");
+  }
+
+  Node *newNode = nodes.create(value);
+
+  try
+  {
+    link(newNode, prevNode);
+  }
+  catch (...)
+  {
+    nodes.destroy(newNode);
+    throw;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::insertBefore(const T &afterValue, const T &value)
+{
+  Node *afterNode = search(afterValue);
+
+  if (afterNode == nullptr)
+  {
+    throw NodeNotFound("Node not found of given data!");
+  }
+
+  Node *newNode = nodes.create(value);
+
+  try
+  {
+    link(newNode, afterNode->prev);
+  }
+  catch (...)
+  {
+    nodes.destroy(newNode);
+    throw;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::removeFront()
+{
+  if (isEmpty())
+  {
+    throw Underflow("DLL is empty!");
+  }
+
+  unlink(head);
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::removeBack()
+{
+  if (isEmpty())
+  {
+    throw Underflow("DLL is empty!");
+  }
+
+  unlink(tail);
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::remove(const T &value, bool isALL)
+{
+  Node *currentNode = search(value);
+
+  while (currentNode)
+  {
+    Node *nextSame = currentNode->nextSame;
+    bool isLast = nextSame == nullptr;
+
+    // The chain entry goes away with its last node
+    unlink(currentNode);
+
+    if (!isALL || isLast)
+    {
+      break;
+    }
+
+    currentNode = nextSame;
+  }
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+bool IndexedDLL<T, Hash, NodeAllocator>::contains(const T &value) const
+{
+  return index.find(value) != index.end();
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+int IndexedDLL<T, Hash, NodeAllocator>::count(const T &value) const
+{
+  auto entry = index.find(value);
+  return entry == index.end() ? 0 : entry->second.count;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+bool IndexedDLL<T, Hash, NodeAllocator>::isEmpty() const
+{
+  return size == 0;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+int IndexedDLL<T, Hash, NodeAllocator>::getSize() const
+{
+  return size;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+typename IndexedDLL<T, Hash, NodeAllocator>::Node *IndexedDLL<T, Hash, NodeAllocator>::search(const T &value) const
+{
+  auto entry = index.find(value);
+  return entry == index.end() ? nullptr : entry->second.first;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::clear()
+{
+  // Frees every node at once instead of one removeFront() at a time
+  nodes.destroyList(head);
+  index.clear();
+  head = tail = nullptr;
+  size = 0;
+}
+
+template <typename T, typename Hash, template <typename> class NodeAllocator>
+void IndexedDLL<T, Hash, NodeAllocator>::copy(const IndexedDLL &obj)
+{
+  if (this != &obj)
+  {
+    clear();
+    for (const Node *currentNode = obj.head; currentNode; currentNode = currentNode->next)
+    {
+      insertBack(currentNode->data);
+    }
+  }
+}
@@ -0,0 +1,208 @@
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef NODE_ALLOCATOR_HPP
+
+#define NODE_ALLOCATOR_HPP
+
+// Node allocators for the linked lists. A list owns one allocator for its
+// Node type and never calls new/delete on nodes itself:
+//
+//   create(args...)   constructs a node and returns it
+//   destroy(node)     destroys a single node
+//   destroyList(node) destroys the chain node, node->next, ... up to a
+//                     nullptr and frees whatever the allocator still holds
+
+// Passed to the node pointer overloads of SLL and CDLL to skip the check
+// that the node belongs to the list, for callers that already know it does
+struct UncheckedNode
+{
+};
+
+const UncheckedNode UNCHECKED_NODE{};
+
+// Plain new/delete for every node
+template <typename Node>
+class HeapAllocator
+{
+public:
+  template <typename... Args>
+  Node *create(Args &&...args)
+  {
+    return new Node(std::forward<Args>(args)...);
+  }
+
+  void destroy(Node *node)
+  {
+    delete node;
+  }
+
+  void destroyList(Node *node)
+  {
+    while (node != nullptr)
+    {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+};
+
+// Carves nodes out of 64 KiB chunks and recycles freed nodes through an
+// intrusive free list, so pushes and pops rarely reach malloc and nodes
+// created together sit next to each other in memory. Chunks are only
+// returned by destroyList(), all at once; with trivially destructible nodes
+// it does not even walk the list.
+template <typename Node>
+class SlabAllocator
+{
+private:
+  // A free slot holds the link to the next free slot in place of a node
+  union Slot
+  {
+    Slot *nextFree;
+    alignas(Node) unsigned char bytes[sizeof(Node)];
+  };
+
+  struct Chunk
+  {
+    Chunk *next;
+  };
+
+  static const std::size_t CHUNK_BYTES = 64 * 1024;
+
+  // Slots start at the first multiple of the slot alignment after the header
+  static const std::size_t SLOTS_OFFSET = (sizeof(Chunk) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+  static const std::size_t SLOTS_PER_CHUNK =
+      CHUNK_BYTES > SLOTS_OFFSET + sizeof(Slot) ? (CHUNK_BYTES - SLOTS_OFFSET) / sizeof(Slot) : 1;
+  static const std::size_t CHUNK_SIZE = SLOTS_OFFSET + SLOTS_PER_CHUNK * sizeof(Slot);
+  static const std::size_t CHUNK_ALIGNMENT = alignof(Slot) > alignof(Chunk) ? alignof(Slot) : alignof(Chunk);
+
+  Chunk *chunks;
+  Slot *freeList;
+
+  // Untouched slots of the newest chunk
+  Slot *nextUnused;
+  Slot *chunkEnd;
+
+  Slot *takeSlot();
+  void addChunk();
+  void release();
+
+public:
+  SlabAllocator();
+  ~SlabAllocator();
+  SlabAllocator(const SlabAllocator &) = delete;
+  SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+  template <typename... Args>
+  Node *create(Args &&...);
+  void destroy(Node *);
+  void destroyList(Node *);
+};
+
+template <typename Node>
+SlabAllocator<Node>::SlabAllocator() : chunks(nullptr), freeList(nullptr), nextUnused(nullptr), chunkEnd(nullptr)
+{
+}
+
+template <typename Node>
+SlabAllocator<Node>::~SlabAllocator()
+{
+  release();
+}
+
+template <typename Node>
+void SlabAllocator<Node>::addChunk()
+{
+  void *memory = ::operator new(CHUNK_SIZE, std::align_val_t(CHUNK_ALIGNMENT));
+
+  Chunk *chunk = static_cast<Chunk *>(memory);
+  chunk->next = chunks;
+  chunks = chunk;
+
+  nextUnused = reinterpret_cast<Slot *>(static_cast<unsigned char *>(memory) + SLOTS_OFFSET);
+  chunkEnd = nextUnused + SLOTS_PER_CHUNK;
+}
+
+template <typename Node>
+typename SlabAllocator<Node>::Slot *SlabAllocator<Node>::takeSlot()
+{
+  // Recently freed slots first, they are likely still in the cache
+  if (freeList != nullptr)
+  {
+    Slot *slot = freeList;
+    freeList = slot->nextFree;
+    return slot;
+  }
+
+  if (nextUnused == chunkEnd)
+  {
+    addChunk();
+  }
+
+  return nextUnused++;
+}
+
+template <typename Node>
+template <typename... Args>
+Node *SlabAllocator<Node>::create(Args &&...args)
+{
+  Slot *slot = takeSlot();
+
+  try
+  {
+    return ::new (static_cast<void *>(slot->bytes)) Node(std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    slot->nextFree = freeList;
+    freeList = slot;
+    throw;
+  }
+}
+
+template <typename Node>
+void SlabAllocator<Node>::destroy(Node *node)
+{
+  node->~Node();
+
+  Slot *slot = reinterpret_cast<Slot *>(node);
+  slot->nextFree = freeList;
+  freeList = slot;
+}
+
+template <typename Node>
+void SlabAllocator<Node>::destroyList(Node *node)
+{
+  if (!std::is_trivially_destructible<Node>::value)
+  {
+    while (node != nullptr)
+    {
+      Node *next = node->next;
+      node->~Node();
+      node = next;
+    }
+  }
+
+  release();
+}
+
+template <typename Node>
+void SlabAllocator<Node>::release()
+{
+  while (chunks != nullptr)
+  {
+    Chunk *next = chunks->next;
+    ::operator delete(static_cast<void *>(chunks), std::align_val_t(CHUNK_ALIGNMENT));
+    chunks = next;
+  }
+
+  freeList = nullptr;
+  nextUnused = nullptr;
+  chunkEnd = nullptr;
+}
+
+#endif
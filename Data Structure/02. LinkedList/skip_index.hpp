@@ -0,0 +1,477 @@
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifndef SKIP_INDEX_HPP
+
+#define SKIP_INDEX_HPP
+
+// Indexable skip list laid over a singly linked list, giving the list
+// O(log n) expected access by position. The list's own next pointers are
+// level 0; a node picked for level 1 or higher (one in four per level) gets
+// a separate tower with a link per level. Every link stores its width, the
+// number of positions it skips, so a search adds up widths on the way down
+// instead of counting nodes.
+//
+// Positions count from the head sentinel: the sentinel is at 0 and the item
+// at index i at i + 1. The last link of every level spans to the end of the
+// list (count + 1), so appending only touches the last tower of each level.
+//
+// The list reports its changes through the hooks below. A change whose
+// position is unknown (e.g. an insert after a given node) marks the index
+// stale, and it is rebuilt by the next positional operation.
+template <typename Node>
+class SkipIndex
+{
+public:
+  static const int MAX_LEVEL = 32;
+
+private:
+  struct Tower;
+
+  struct Link
+  {
+    Tower *next;
+    int width;
+  };
+
+  // The links of a tower follow it in the same block; link(t, l) is level l
+  struct Tower
+  {
+    Node *node;
+    int height;
+  };
+
+public:
+  // The last tower before a position on every level, the position of each,
+  // and the node just before it (nullptr at the front)
+  struct Path
+  {
+    int index;
+    Tower *towers[MAX_LEVEL];
+    int positions[MAX_LEVEL];
+    Node *prevNode;
+  };
+
+private:
+  // nullptr while the index is disabled
+  Tower *sentinel;
+  Tower *last[MAX_LEVEL];
+  int levels;
+  int count;
+  bool stale;
+  std::uint32_t seed;
+
+  static Link &link(Tower *, int);
+  static Tower *makeTower(Node *, int);
+  static void freeTower(Tower *);
+
+  int randomHeight();
+  void freeTowers();
+  void reset();
+
+  void pathToFront(Path &) const;
+  void pathToBack(Path &) const;
+
+public:
+  SkipIndex();
+  ~SkipIndex();
+  SkipIndex(const SkipIndex &) = delete;
+  SkipIndex &operator=(const SkipIndex &) = delete;
+
+  // Builds the towers for the list starting at the given node
+  void build(Node *);
+
+  // Drops every tower; the hooks do nothing until the next build()
+  void disable();
+
+  bool isEnabled() const;
+
+  // True if positional operations can use the index, after rebuilding it
+  // from the given head if it went stale
+  bool ready(Node *);
+
+  int size() const;
+
+  // Node at the given index, which must be in range
+  Node *find(Node *, int) const;
+
+  // Fills the path to an index; insert() and erase() then take it
+  void pathTo(Node *, int, Path &) const;
+  void insert(Path &, Node *);
+  void erase(Path &, Node *);
+
+  // Hooks for changes at the ends and changes at unknown positions
+  void pushedFront(Node *);
+  void pushedBack(Node *);
+  void poppedFront(Node *);
+  void invalidate();
+};
+
+template <typename Node>
+SkipIndex<Node>::SkipIndex() : sentinel(nullptr), levels(0), count(0), stale(false), seed(0x9E3779B9u)
+{
+}
+
+template <typename Node>
+SkipIndex<Node>::~SkipIndex()
+{
+  disable();
+}
+
+template <typename Node>
+typename SkipIndex<Node>::Link &SkipIndex<Node>::link(Tower *tower, int level)
+{
+  return reinterpret_cast<Link *>(tower + 1)[level - 1];
+}
+
+template <typename Node>
+typename SkipIndex<Node>::Tower *SkipIndex<Node>::makeTower(Node *node, int height)
+{
+  void *block = ::operator new(sizeof(Tower) + static_cast<std::size_t>(height) * sizeof(Link));
+
+  Tower *tower = ::new (block) Tower{node, height};
+  for (int level = 1; level <= height; level++)
+  {
+    ::new (static_cast<void *>(&link(tower, level))) Link{nullptr, 0};
+  }
+
+  return tower;
+}
+
+template <typename Node>
+void SkipIndex<Node>::freeTower(Tower *tower)
+{
+  ::operator delete(static_cast<void *>(tower));
+}
+
+template <typename Node>
+int SkipIndex<Node>::randomHeight()
+{
+  // xorshift32; two bits per level give the one-in-four promotion
+  int height = 0;
+  while (height < MAX_LEVEL - 1)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    if ((seed & 3) != 0)
+    {
+      break;
+    }
+    height++;
+  }
+
+  return height;
+}
+
+template <typename Node>
+void SkipIndex<Node>::freeTowers()
+{
+  // Every tower is on level 1
+  Tower *tower = link(sentinel, 1).next;
+  while (tower != nullptr)
+  {
+    Tower *next = link(tower, 1).next;
+    freeTower(tower);
+    tower = next;
+  }
+}
+
+template <typename Node>
+void SkipIndex<Node>::reset()
+{
+  for (int level = 1; level < MAX_LEVEL; level++)
+  {
+    link(sentinel, level) = Link{nullptr, 1};
+    last[level] = sentinel;
+  }
+
+  levels = 0;
+  count = 0;
+  stale = false;
+}
+
+template <typename Node>
+void SkipIndex<Node>::build(Node *head)
+{
+  if (sentinel == nullptr)
+  {
+    sentinel = makeTower(nullptr, MAX_LEVEL - 1);
+  }
+  else
+  {
+    freeTowers();
+  }
+
+  reset();
+
+  for (Node *node = head; node != nullptr; node = node->next)
+  {
+    Path path;
+    pathToBack(path);
+    insert(path, node);
+  }
+}
+
+template <typename Node>
+void SkipIndex<Node>::disable()
+{
+  if (sentinel != nullptr)
+  {
+    freeTowers();
+    freeTower(sentinel);
+    sentinel = nullptr;
+  }
+
+  levels = 0;
+  count = 0;
+  stale = false;
+}
+
+template <typename Node>
+bool SkipIndex<Node>::isEnabled() const
+{
+  return sentinel != nullptr;
+}
+
+template <typename Node>
+bool SkipIndex<Node>::ready(Node *head)
+{
+  if (sentinel == nullptr)
+  {
+    return false;
+  }
+
+  if (stale)
+  {
+    build(head);
+  }
+
+  return true;
+}
+
+template <typename Node>
+int SkipIndex<Node>::size() const
+{
+  return count;
+}
+
+template <typename Node>
+Node *SkipIndex<Node>::find(Node *head, int index) const
+{
+  int target = index + 1;
+  Tower *tower = sentinel;
+  int position = 0;
+
+  for (int level = levels; level >= 1; level--)
+  {
+    while (link(tower, level).next != nullptr && position + link(tower, level).width <= target)
+    {
+      position += link(tower, level).width;
+      tower = link(tower, level).next;
+    }
+  }
+
+  Node *node = tower->node;
+  while (position < target)
+  {
+    node = node == nullptr ? head : node->next;
+    position++;
+  }
+
+  return node;
+}
+
+template <typename Node>
+void SkipIndex<Node>::pathTo(Node *head, int index, Path &path) const
+{
+  Tower *tower = sentinel;
+  int position = 0;
+
+  for (int level = levels; level >= 1; level--)
+  {
+    while (link(tower, level).next != nullptr && position + link(tower, level).width <= index)
+    {
+      position += link(tower, level).width;
+      tower = link(tower, level).next;
+    }
+
+    path.towers[level] = tower;
+    path.positions[level] = position;
+  }
+
+  Node *node = tower->node;
+  while (position < index)
+  {
+    node = node == nullptr ? head : node->next;
+    position++;
+  }
+
+  path.index = index;
+  path.prevNode = node;
+}
+
+template <typename Node>
+void SkipIndex<Node>::pathToFront(Path &path) const
+{
+  for (int level = 1; level <= levels; level++)
+  {
+    path.towers[level] = sentinel;
+    path.positions[level] = 0;
+  }
+
+  path.index = 0;
+  path.prevNode = nullptr;
+}
+
+template <typename Node>
+void SkipIndex<Node>::pathToBack(Path &path) const
+{
+  // The last link of a level spans to the end, which gives its position
+  for (int level = 1; level <= levels; level++)
+  {
+    path.towers[level] = last[level];
+    path.positions[level] = count + 1 - link(last[level], level).width;
+  }
+
+  path.index = count;
+  path.prevNode = nullptr;
+}
+
+template <typename Node>
+void SkipIndex<Node>::insert(Path &path, Node *node)
+{
+  int position = path.index + 1;
+  int height = randomHeight();
+  Tower *tower = height > 0 ? makeTower(node, height) : nullptr;
+
+  // New levels start as a single link from the sentinel to the end
+  for (int level = levels + 1; level <= height; level++)
+  {
+    link(sentinel, level) = Link{nullptr, count + 1};
+    last[level] = sentinel;
+    path.towers[level] = sentinel;
+    path.positions[level] = 0;
+  }
+
+  if (height > levels)
+  {
+    levels = height;
+  }
+
+  for (int level = 1; level <= levels; level++)
+  {
+    Link &before = link(path.towers[level], level);
+
+    if (level <= height)
+    {
+      // Split the link that spans the new position
+      Link &own = link(tower, level);
+      own.next = before.next;
+      own.width = path.positions[level] + before.width + 1 - position;
+      before.next = tower;
+      before.width = position - path.positions[level];
+
+      if (own.next == nullptr)
+      {
+        last[level] = tower;
+      }
+    }
+    else
+    {
+      before.width++;
+    }
+  }
+
+  count++;
+}
+
+template <typename Node>
+void SkipIndex<Node>::erase(Path &path, Node *node)
+{
+  Tower *tower = nullptr;
+  if (levels > 0)
+  {
+    Tower *candidate = link(path.towers[1], 1).next;
+    if (candidate != nullptr && candidate->node == node)
+    {
+      tower = candidate;
+    }
+  }
+
+  for (int level = 1; level <= levels; level++)
+  {
+    Link &before = link(path.towers[level], level);
+
+    if (tower != nullptr && level <= tower->height)
+    {
+      // Join the links on both sides of the removed tower
+      before.width += link(tower, level).width - 1;
+      before.next = link(tower, level).next;
+
+      if (last[level] == tower)
+      {
+        last[level] = path.towers[level];
+      }
+    }
+    else
+    {
+      before.width--;
+    }
+  }
+
+  while (levels > 0 && link(sentinel, levels).next == nullptr)
+  {
+    levels--;
+  }
+
+  if (tower != nullptr)
+  {
+    freeTower(tower);
+  }
+
+  count--;
+}
+
+template <typename Node>
+void SkipIndex<Node>::pushedFront(Node *node)
+{
+  if (sentinel != nullptr && !stale)
+  {
+    Path path;
+    pathToFront(path);
+    insert(path, node);
+  }
+}
+
+template <typename Node>
+void SkipIndex<Node>::pushedBack(Node *node)
+{
+  if (sentinel != nullptr && !stale)
+  {
+    Path path;
+    pathToBack(path);
+    insert(path, node);
+  }
+}
+
+template <typename Node>
+void SkipIndex<Node>::poppedFront(Node *node)
+{
+  if (sentinel != nullptr && !stale)
+  {
+    Path path;
+    pathToFront(path);
+    erase(path, node);
+  }
+}
+
+template <typename Node>
+void SkipIndex<Node>::invalidate()
+{
+  stale = true;
+}
+
+#endif
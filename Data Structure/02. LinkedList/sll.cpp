@@ -2,10 +2,12 @@
 
 #include <iostream>
 #include "custom_exception"
+#include "node_allocator.hpp"
+#include "skip_index.hpp"
 
 #define OUT_OF_RANGE "Invalid position!"
 
-template <typename T>
+template <typename T, template <typename> class NodeAllocator = SlabAllocator>
 class SLL
 {
 private:
@@ -13,18 +15,33 @@ private:
   {
     T data;
     Node *next;
-    Node(T value)
+
+    // The list the node belongs to, so a node pointer is checked in O(1)
+    const SLL *owner;
+
+    Node(T value, const SLL *list)
     {
       data = value;
       next = nullptr;
+      owner = list;
     }
   };
 
   Node *head;
   Node *tail;
 
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
+  // Optional skip list over the nodes for positional access; mutable since
+  // a stale index is rebuilt on the next lookup, const ones included
+  mutable SkipIndex<Node> skipIndex;
+
 protected:
   void clear();
+  // O(1): compares the node's owner tag with this list. A pointer to a
+  // node that was removed is invalid, as with std::list iterators; it is
+  // not detected, since its memory may already hold another node.
   bool isNodePresent(const Node *) const;
 
 public:
@@ -37,6 +54,7 @@ public:
   void pushBack(T);
   void insertAt(T, int);
   void insertAfter(T, Node *);
+  void insertAfter(T, Node *, UncheckedNode);
   void popFront();
   void popBack();
   void removeAt(int);
@@ -44,29 +62,38 @@ public:
   Node *findByValue(T) const;
   Node *findByIndex(int) const;
   void printList() const;
+
+  // When enabled, findByIndex, insertAt, removeAt and popBack take
+  // O(log n) expected time instead of walking from the head. pushFront,
+  // pushBack and popFront keep their constant time, and an insertAfter in
+  // the middle defers the index update to the next positional operation.
+  void setIndexed(bool);
+  bool isIndexed() const;
 };
 
-template <typename T>
-SLL<T>::SLL()
+template <typename T, template <typename> class NodeAllocator>
+SLL<T, NodeAllocator>::SLL()
 {
   head = nullptr;
   tail = nullptr;
 }
 
-template <typename T>
-SLL<T>::~SLL()
+template <typename T, template <typename> class NodeAllocator>
+SLL<T, NodeAllocator>::~SLL()
 {
   clear();
   head = nullptr;
   tail = nullptr;
 }
 
-template <typename T>
-SLL<T>::SLL(const SLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+SLL<T, NodeAllocator>::SLL(const SLL &obj)
 {
   head = tail = nullptr;
 
-  if (*this != &obj)
+  setIndexed(obj.isIndexed());
+
+  if (this != &obj)
   {
     Node *currentNode = obj.head;
     while (currentNode)
@@ -77,8 +104,8 @@ SLL<T>::SLL(const SLL &obj)
   }
 }
 
-template <typename T>
-SLL<T> &SLL<T>::operator=(const SLL &obj)
+template <typename T, template <typename> class NodeAllocator>
+SLL<T, NodeAllocator> &SLL<T, NodeAllocator>::operator=(const SLL &obj)
 {
   if (this != &obj)
   {
@@ -95,10 +122,10 @@ SLL<T> &SLL<T>::operator=(const SLL &obj)
   return *this;
 }
 
-template <typename T>
-void SLL<T>::pushFront(T value)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::pushFront(T value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
   newNode->next = head;
 
   if (head == nullptr)
@@ -107,12 +134,13 @@ void SLL<T>::pushFront(T value)
   }
 
   head = newNode;
+  skipIndex.pushedFront(newNode);
 }
 
-template <typename T>
-void SLL<T>::pushBack(T value)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::pushBack(T value)
 {
-  Node *newNode = new Node(value);
+  Node *newNode = nodes.create(value, this);
 
   if (isEmpty())
   {
@@ -123,10 +151,12 @@ void SLL<T>::pushBack(T value)
     tail->next = newNode;
     tail = newNode;
   }
+
+  skipIndex.pushedBack(newNode);
 }
 
-template <typename T>
-void SLL<T>::insertAt(T value, int pos)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::insertAt(T value, int pos)
 {
   if (pos < 0)
   {
@@ -140,6 +170,29 @@ void SLL<T>::insertAt(T value, int pos)
     return;
   }
 
+  if (skipIndex.ready(head))
+  {
+    if (pos > skipIndex.size())
+    {
+      throw std::out_of_range(OUT_OF_RANGE);
+    }
+
+    typename SkipIndex<Node>::Path path;
+    skipIndex.pathTo(head, pos, path);
+
+    Node *newNode = nodes.create(value, this);
+    newNode->next = path.prevNode->next;
+    path.prevNode->next = newNode;
+
+    if (path.prevNode == tail)
+    {
+      tail = newNode;
+    }
+
+    skipIndex.insert(path, newNode);
+    return;
+  }
+
   Node *currentNode = head;
   int i = 1;
 
@@ -164,27 +217,44 @@ void SLL<T>::insertAt(T value, int pos)
   else
   {
     // insert node at middle of the list
-    Node *newNode = new Node(value);
+    Node *newNode = nodes.create(value, this);
     newNode->next = currentNode->next;
     currentNode->next = newNode;
   }
 }
 
-template <typename T>
-void SLL<T>::insertAfter(T value, Node *node)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::insertAfter(T value, Node *node)
 {
   if (isNodePresent(node) == false)
   {
     throw InvalidNodePointer();
   }
 
-  Node *newNode = new Node(value);
+  insertAfter(value, node, UNCHECKED_NODE);
+}
+
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::insertAfter(T value, Node *node, UncheckedNode)
+{
+  Node *newNode = nodes.create(value, this);
   newNode->next = node->next;
   node->next = newNode;
+
+  if (node == tail)
+  {
+    tail = newNode;
+    skipIndex.pushedBack(newNode);
+  }
+  else
+  {
+    // The position of the node is unknown here
+    skipIndex.invalidate();
+  }
 }
 
-template <typename T>
-void SLL<T>::popFront()
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::popFront()
 {
   if (isEmpty())
   {
@@ -199,11 +269,12 @@ void SLL<T>::popFront()
     tail = nullptr;
   }
 
-  delete temp;
+  skipIndex.poppedFront(temp);
+  nodes.destroy(temp);
 }
 
-template <typename T>
-void SLL<T>::popBack()
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::popBack()
 {
   if (isEmpty())
   {
@@ -212,24 +283,36 @@ void SLL<T>::popBack()
 
   if (head == tail)
   {
-    delete tail;
+    skipIndex.poppedFront(tail);
+    nodes.destroy(tail);
     head = tail = nullptr;
     return;
   }
 
   Node *prevNode = head;
-  while (prevNode->next != tail)
+
+  if (skipIndex.ready(head))
   {
-    prevNode = prevNode->next;
+    typename SkipIndex<Node>::Path path;
+    skipIndex.pathTo(head, skipIndex.size() - 1, path);
+    skipIndex.erase(path, tail);
+    prevNode = path.prevNode;
+  }
+  else
+  {
+    while (prevNode->next != tail)
+    {
+      prevNode = prevNode->next;
+    }
   }
 
   prevNode->next = nullptr;
-  delete tail;
+  nodes.destroy(tail);
   tail = prevNode;
 }
 
-template <typename T>
-void SLL<T>::removeAt(int pos)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::removeAt(int pos)
 {
   if (pos < 0)
   {
@@ -248,29 +331,55 @@ void SLL<T>::removeAt(int pos)
   }
 
   Node *prevNode = head;
-  for (int i = 1; i < pos && prevNode->next != nullptr; i++)
+  typename SkipIndex<Node>::Path path;
+  bool indexed = skipIndex.ready(head);
+
+  if (indexed)
   {
-    prevNode = prevNode->next;
-  }
+    if (pos >= skipIndex.size())
+    {
+      throw std::out_of_range(OUT_OF_RANGE);
+    }
 
-  if (prevNode->next == nullptr)
+    skipIndex.pathTo(head, pos, path);
+    prevNode = path.prevNode;
+  }
+  else
   {
-    throw std::out_of_range(OUT_OF_RANGE);
+    for (int i = 1; i < pos && prevNode->next != nullptr; i++)
+    {
+      prevNode = prevNode->next;
+    }
+
+    if (prevNode->next == nullptr)
+    {
+      throw std::out_of_range(OUT_OF_RANGE);
+    }
   }
 
   Node *temp = prevNode->next;
   prevNode->next = prevNode->next->next;
-  delete temp;
+
+  if (temp == tail)
+  {
+    tail = prevNode;
+  }
+
+  if (indexed)
+  {
+    skipIndex.erase(path, temp);
+  }
+  nodes.destroy(temp);
 }
 
-template <typename T>
-bool SLL<T>::isEmpty() const
+template <typename T, template <typename> class NodeAllocator>
+bool SLL<T, NodeAllocator>::isEmpty() const
 {
   return head == nullptr;
 }
 
-template <typename T>
-SLL<T>::Node *SLL<T>::findByValue(T value) const
+template <typename T, template <typename> class NodeAllocator>
+typename SLL<T, NodeAllocator>::Node *SLL<T, NodeAllocator>::findByValue(T value) const
 {
   Node *currentNode = head;
   while (currentNode)
@@ -285,9 +394,14 @@ SLL<T>::Node *SLL<T>::findByValue(T value) const
   return nullptr;
 }
 
-template <typename T>
-SLL<T>::Node *SLL<T>::findByIndex(int pos) const
+template <typename T, template <typename> class NodeAllocator>
+typename SLL<T, NodeAllocator>::Node *SLL<T, NodeAllocator>::findByIndex(int pos) const
 {
+  if (skipIndex.ready(head))
+  {
+    return pos >= 0 && pos < skipIndex.size() ? skipIndex.find(head, pos) : nullptr;
+  }
+
   Node *currentNode = head;
   for (int i = 0; i < pos && currentNode != nullptr; i++)
   {
@@ -302,8 +416,8 @@ SLL<T>::Node *SLL<T>::findByIndex(int pos) const
   return nullptr;
 }
 
-template <typename T>
-void SLL<T>::printList() const
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::printList() const
 {
   Node *currentNode = head;
 
@@ -319,30 +433,42 @@ void SLL<T>::printList() const
   }
 }
 
-template <typename T>
-bool SLL<T>::isNodePresent(const Node *node) const
+template <typename T, template <typename> class NodeAllocator>
+bool SLL<T, NodeAllocator>::isNodePresent(const Node *node) const
 {
-  Node *currentNode = head;
+  return node != nullptr && node->owner == this;
+}
 
-  while (currentNode)
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::clear()
+{
+  // Frees every node at once instead of one popFront() at a time
+  nodes.destroyList(head);
+  head = tail = nullptr;
+
+  if (skipIndex.isEnabled())
   {
-    if (currentNode==node)
-    {
-      return true;
-    }
-    currentNode = currentNode->next;
+    skipIndex.build(head);
   }
-
-  return false;
 }
 
-template <typename T>
-void SLL<T>::clear()
+template <typename T, template <typename> class NodeAllocator>
+void SLL<T, NodeAllocator>::setIndexed(bool enabled)
 {
-  while (head)
+  if (!enabled)
   {
-    popFront();
+    skipIndex.disable();
   }
+  else if (!skipIndex.isEnabled())
+  {
+    skipIndex.build(head);
+  }
+}
+
+template <typename T, template <typename> class NodeAllocator>
+bool SLL<T, NodeAllocator>::isIndexed() const
+{
+  return skipIndex.isEnabled();
 }
 
 int main()
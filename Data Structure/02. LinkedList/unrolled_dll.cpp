@@ -0,0 +1,479 @@
+// Unrolled Doubly Linked List
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <utility>
+#include "custom_exception"
+#include "node_allocator.hpp"
+
+// Every node holds up to K items in a small array, so a scan reads K
+// contiguous values per pointer chase and the per-node pointers are shared
+// by K items. A full node is split in half when an item is inserted into
+// it; a node that drops below half full after a removal borrows items from
+// its neighbour or merges with it. The default K fills about two cache lines.
+template <typename T, int K = (sizeof(T) >= 32 ? 4 : static_cast<int>(128 / sizeof(T))),
+          template <typename> class NodeAllocator = SlabAllocator>
+class UnrolledDLL
+{
+  static_assert(K >= 2, "Nodes must hold at least two items.");
+
+private:
+  struct Node
+  {
+    Node *prev;
+    Node *next;
+    int count;
+
+    // Raw storage: only the first 'count' items are constructed
+    alignas(T) unsigned char storage[K * sizeof(T)];
+
+    Node() : prev(nullptr), next(nullptr), count(0) {}
+    ~Node() { std::destroy_n(items(), count); }
+
+    T *items() { return std::launder(reinterpret_cast<T *>(storage)); }
+    const T *items() const { return std::launder(reinterpret_cast<const T *>(storage)); }
+  };
+
+  // An item's node and its index in that node
+  struct Position
+  {
+    Node *node;
+    int index;
+  };
+
+  int size;
+  Node *head;
+  Node *tail;
+
+  // Every node of the list comes from here
+  NodeAllocator<Node> nodes;
+
+  // Adds an empty node after the given one (at the front for nullptr)
+  Node *linkAfter(Node *);
+  void unlink(Node *);
+
+  // Moves 'n' items from one node's storage into another's raw slots
+  static void moveItems(Node *, int, Node *, int, int);
+
+  // Moves the upper half of a full node into a new node after it
+  Node *split(Node *);
+
+  void insertAt(Node *, int, const T &);
+  void removeAt(Node *, int);
+
+  // Brings a node back to at least half full by borrowing from or merging
+  // with a neighbour, and returns the next node to look at
+  Node *rebalance(Node *);
+
+protected:
+  void clear();
+  Position search(const T &) const;
+  void copy(const UnrolledDLL &);
+
+public:
+  UnrolledDLL() : size(0), head(nullptr), tail(nullptr) {}
+  ~UnrolledDLL();
+  UnrolledDLL(const UnrolledDLL &);
+  UnrolledDLL &operator=(const UnrolledDLL &);
+
+  void insertFront(const T &);
+  void insertBack(const T &);
+  // Inserts the value after / before the first occurrence of the first argument
+  void insertAfter(const T &, const T &);
+  void insertBefore(const T &, const T &);
+  void removeFront();
+  void removeBack();
+  // Removes the first occurrence of the value if 'false' is passed; removes all occurrences if 'true' is passed.
+  void remove(const T &, bool = true);
+  bool contains(const T &) const;
+  bool isEmpty() const;
+  int getSize() const;
+
+  friend std::ostream &operator<<(std::ostream &dout, const UnrolledDLL &obj)
+  {
+    for (const Node *currentNode = obj.head; currentNode; currentNode = currentNode->next)
+    {
+      for (int i = 0; i < currentNode->count; i++)
+      {
+        dout << currentNode->items()[i];
+        if (currentNode != obj.tail || i + 1 < currentNode->count)
+        {
+          dout << " <--> ";
+        }
+      }
+    }
+
+    if (obj.isEmpty())
+    {
+      dout << "List is empty!";
+    }
+
+    return dout;
+  }
+};
+
+template <typename T, int K, template <typename> class NodeAllocator>
+UnrolledDLL<T, K, NodeAllocator>::~UnrolledDLL()
+{
+  clear();
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+UnrolledDLL<T, K, NodeAllocator>::UnrolledDLL(const UnrolledDLL &obj) : size(0), head(nullptr), tail(nullptr)
+{
+  copy(obj);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+UnrolledDLL<T, K, NodeAllocator> &UnrolledDLL<T, K, NodeAllocator>::operator=(const UnrolledDLL &obj)
+{
+  copy(obj);
+
+  return *this;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+typename UnrolledDLL<T, K, NodeAllocator>::Node *UnrolledDLL<T, K, NodeAllocator>::linkAfter(Node *prevNode)
+{
+  Node *newNode = nodes.create();
+  newNode->prev = prevNode;
+  newNode->next = prevNode == nullptr ? head : prevNode->next;
+
+  if (newNode->next == nullptr)
+  {
+    tail = newNode;
+  }
+  else
+  {
+    newNode->next->prev = newNode;
+  }
+
+  if (prevNode == nullptr)
+  {
+    head = newNode;
+  }
+  else
+  {
+    prevNode->next = newNode;
+  }
+
+  return newNode;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::unlink(Node *node)
+{
+  if (node->prev == nullptr)
+  {
+    head = node->next;
+  }
+  else
+  {
+    node->prev->next = node->next;
+  }
+
+  if (node->next == nullptr)
+  {
+    tail = node->prev;
+  }
+  else
+  {
+    node->next->prev = node->prev;
+  }
+
+  nodes.destroy(node);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::moveItems(Node *from, int fromIndex, Node *to, int toIndex, int n)
+{
+  T *source = from->items() + fromIndex;
+  T *dest = to->items() + toIndex;
+
+  for (int i = 0; i < n; i++)
+  {
+    ::new (static_cast<void *>(dest + i)) T(std::move(source[i]));
+    source[i].~T();
+  }
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+typename UnrolledDLL<T, K, NodeAllocator>::Node *UnrolledDLL<T, K, NodeAllocator>::split(Node *node)
+{
+  Node *newNode = linkAfter(node);
+  int keep = K / 2;
+
+  moveItems(node, keep, newNode, 0, K - keep);
+  newNode->count = K - keep;
+  node->count = keep;
+
+  return newNode;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::insertAt(Node *node, int index, const T &value)
+{
+  if (node->count == K)
+  {
+    Node *upper = split(node);
+    if (index > node->count)
+    {
+      index -= node->count;
+      node = upper;
+    }
+  }
+
+  T *items = node->items();
+  if (index == node->count)
+  {
+    ::new (static_cast<void *>(items + index)) T(value);
+  }
+  else
+  {
+    // Copy first: the value may live in this node
+    T copy(value);
+    ::new (static_cast<void *>(items + node->count)) T(std::move(items[node->count - 1]));
+    std::move_backward(items + index, items + node->count - 1, items + node->count);
+    items[index] = std::move(copy);
+  }
+
+  node->count++;
+  size++;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::removeAt(Node *node, int index)
+{
+  T *items = node->items();
+  std::move(items + index + 1, items + node->count, items + index);
+  items[node->count - 1].~T();
+
+  node->count--;
+  size--;
+
+  rebalance(node);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+typename UnrolledDLL<T, K, NodeAllocator>::Node *UnrolledDLL<T, K, NodeAllocator>::rebalance(Node *node)
+{
+  if (node->count == 0)
+  {
+    Node *nextNode = node->next;
+    unlink(node);
+    return nextNode;
+  }
+
+  if (node->count >= K / 2)
+  {
+    return node->next;
+  }
+
+  Node *nextNode = node->next;
+
+  // The last node can only merge into the one before it
+  if (nextNode == nullptr)
+  {
+    Node *prevNode = node->prev;
+    if (prevNode != nullptr && prevNode->count + node->count <= K)
+    {
+      moveItems(node, 0, prevNode, prevNode->count, node->count);
+      prevNode->count += node->count;
+      node->count = 0;
+      unlink(node);
+    }
+    return nullptr;
+  }
+
+  if (node->count + nextNode->count <= K)
+  {
+    moveItems(nextNode, 0, node, node->count, nextNode->count);
+    node->count += nextNode->count;
+    nextNode->count = 0;
+    unlink(nextNode);
+
+    // Still under half full if the neighbour was too
+    return node;
+  }
+
+  // Share the items evenly; both halves end up at least half full
+  int take = (node->count + nextNode->count) / 2 - node->count;
+  T *nextItems = nextNode->items();
+
+  moveItems(nextNode, 0, node, node->count, take);
+  node->count += take;
+
+  for (int i = 0; i + take < nextNode->count; i++)
+  {
+    ::new (static_cast<void *>(nextItems + i)) T(std::move(nextItems[i + take]));
+    nextItems[i + take].~T();
+  }
+  nextNode->count -= take;
+
+  return nextNode;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::insertFront(const T &value)
+{
+  // A full head gets a fresh node in front of it rather than a split, so
+  // repeated front insertions keep the nodes full
+  if (head == nullptr || head->count == K)
+  {
+    linkAfter(nullptr);
+  }
+
+  insertAt(head, 0, value);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::insertBack(const T &value)
+{
+  if (tail == nullptr || tail->count == K)
+  {
+    linkAfter(tail);
+  }
+
+  insertAt(tail, tail->count, value);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::insertAfter(const T &prevValue, const T &value)
+{
+  Position position = search(prevValue);
+
+  if (position.node == nullptr)
+  {
+    throw NodeNotFound("Node not found of given data!");
+  }
+
+  insertAt(position.node, position.index + 1, value);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::insertBefore(const T &afterValue, const T &value)
+{
+  Position position = search(afterValue);
+
+  if (position.node == nullptr)
+  {
+    throw NodeNotFound("Node not found of given data!");
+  }
+
+  insertAt(position.node, position.index, value);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::removeFront()
+{
+  if (isEmpty())
+  {
+    throw Underflow("List is empty!");
+  }
+
+  removeAt(head, 0);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::removeBack()
+{
+  if (isEmpty())
+  {
+    throw Underflow("List is empty!");
+  }
+
+  removeAt(tail, tail->count - 1);
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::remove(const T &value, bool isALL)
+{
+  if (!isALL)
+  {
+    Position position = search(value);
+    if (position.node != nullptr)
+    {
+      removeAt(position.node, position.index);
+    }
+    return;
+  }
+
+  // Compact every node in place first, then rebalance the nodes in one
+  // pass, instead of restructuring the list after every removal
+  for (Node *currentNode = head; currentNode; currentNode = currentNode->next)
+  {
+    T *items = currentNode->items();
+    int kept = static_cast<int>(std::remove(items, items + currentNode->count, value) - items);
+
+    std::destroy(items + kept, items + currentNode->count);
+    size -= currentNode->count - kept;
+    currentNode->count = kept;
+  }
+
+  Node *currentNode = head;
+  while (currentNode)
+  {
+    currentNode = rebalance(currentNode);
+  }
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+bool UnrolledDLL<T, K, NodeAllocator>::contains(const T &value) const
+{
+  return search(value).node != nullptr;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+bool UnrolledDLL<T, K, NodeAllocator>::isEmpty() const
+{
+  return size == 0;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+int UnrolledDLL<T, K, NodeAllocator>::getSize() const
+{
+  return size;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+typename UnrolledDLL<T, K, NodeAllocator>::Position UnrolledDLL<T, K, NodeAllocator>::search(const T &value) const
+{
+  for (Node *targetNode = head; targetNode; targetNode = targetNode->next)
+  {
+    const T *items = targetNode->items();
+    const T *found = std::find(items, items + targetNode->count, value);
+
+    if (found != items + targetNode->count)
+    {
+      return Position{targetNode, static_cast<int>(found - items)};
+    }
+  }
+
+  return Position{nullptr, 0};
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::clear()
+{
+  // Frees every node at once; node destructors end their items
+  nodes.destroyList(head);
+  head = tail = nullptr;
+  size = 0;
+}
+
+template <typename T, int K, template <typename> class NodeAllocator>
+void UnrolledDLL<T, K, NodeAllocator>::copy(const UnrolledDLL &obj)
+{
+  if (this != &obj)
+  {
+    clear();
+    for (const Node *currentNode = obj.head; currentNode; currentNode = currentNode->next)
+    {
+      for (int i = 0; i < currentNode->count; i++)
+      {
+        insertBack(currentNode->items()[i]);
+      }
+    }
+  }
+}
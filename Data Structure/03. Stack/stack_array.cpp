@@ -24,7 +24,7 @@ public:
 
   void push(const T &);
   T pop();
-  T peek() const;
+  const T &peek() const;
   bool isEmpty() const;
   bool isFull() const;
   int getCapacity() const;
@@ -93,7 +93,7 @@ T Stack<T>::pop()
 }
 
 template <typename T>
-T Stack<T>::peek() const
+const T &Stack<T>::peek() const
 {
   if (isEmpty())
   {
@@ -27,7 +27,7 @@ public:
 
   void push(const T &);
   T pop();
-  T peek() const;
+  const T &peek() const;
   bool isEmpty() const;
   int getLength() const;
 
@@ -130,7 +130,7 @@ T Stack<T>::pop()
 }
 
 template <typename T>
-T Stack<T>::peek() const
+const T &Stack<T>::peek() const
 {
   if (isEmpty())
   {